@@ -26,6 +26,9 @@ public class ExtraLogic : ModuleRules
 			new string[]
 			{
 				"Core",
+				"GameplayTags",
+				// Public headers expose blackboard and behavior tree types
+				"AIModule",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -38,7 +41,6 @@ public class ExtraLogic : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
-                "AIModule",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
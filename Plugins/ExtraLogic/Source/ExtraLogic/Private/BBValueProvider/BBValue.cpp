@@ -0,0 +1,109 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+
+#include "BBValueProvider/BBValue.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Class.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Rotator.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_String.h"
+
+
+void FBBValue::SetBlackboardValue(UBlackboardComponent& Blackboard) const
+{
+	SetValue(Blackboard, GetKeyID(Blackboard));
+}
+
+void FBBValue::SetBlackboardValues(UBlackboardComponent* Blackboard, TConstArrayView<FInstancedStruct> Values)
+{
+	if (!ensureMsgf(Blackboard, TEXT("No blackboard provided!")) || Values.IsEmpty())
+	{
+		return;
+	}
+
+	Blackboard->PauseObserverNotifications();
+	for (const FInstancedStruct& Value : Values)
+	{
+		if (const FBBValue* BBValue = Value.GetPtr<FBBValue>())
+		{
+			BBValue->SetBlackboardValue(*Blackboard);
+		}
+	}
+	Blackboard->ResumeObserverNotifications(true);
+}
+
+FBlackboard::FKey FBBValue::GetKeyID(const UBlackboardComponent& Blackboard) const
+{
+	const UBlackboardData* BlackboardAsset = Blackboard.GetBlackboardAsset();
+	if (!BlackboardAsset)
+	{
+		return FBlackboard::InvalidKey;
+	}
+
+	// Single binding is enough, values are set for one asset most of the time
+	if (BoundAsset.Get() != BlackboardAsset)
+	{
+		BoundAsset = BlackboardAsset;
+		BoundKey = BlackboardAsset->GetKeyID(BlackboardKeyName);
+	}
+	return BoundKey;
+}
+
+void FBBValue_Bool::SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const
+{
+	Blackboard.SetValue<UBlackboardKeyType_Bool>(Key, Value);
+}
+
+void FBBValue_Int::SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const
+{
+	Blackboard.SetValue<UBlackboardKeyType_Int>(Key, Value);
+}
+
+void FBBValue_Float::SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const
+{
+	Blackboard.SetValue<UBlackboardKeyType_Float>(Key, Value);
+}
+
+void FBBValue_Vector::SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const
+{
+	Blackboard.SetValue<UBlackboardKeyType_Vector>(Key, Value);
+}
+
+void FBBValue_Actor::SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const
+{
+	if (Value.IsValid())
+	{
+		Blackboard.SetValue<UBlackboardKeyType_Object>(Key, Value.Get());
+	}
+}
+
+void FBBValue_Class::SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const
+{
+	Blackboard.SetValue<UBlackboardKeyType_Class>(Key, Value);
+}
+
+void FBBValue_Enum::SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const
+{
+	Blackboard.SetValue<UBlackboardKeyType_Enum>(Key, Value);
+}
+
+void FBBValue_Rotator::SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const
+{
+	Blackboard.SetValue<UBlackboardKeyType_Rotator>(Key, Value);
+}
+
+void FBBValue_Name::SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const
+{
+	Blackboard.SetValue<UBlackboardKeyType_Name>(Key, Value);
+}
+
+void FBBValue_String::SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const
+{
+	Blackboard.SetValue<UBlackboardKeyType_String>(Key, Value);
+}
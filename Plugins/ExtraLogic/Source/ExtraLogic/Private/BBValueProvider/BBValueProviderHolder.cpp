@@ -2,6 +2,7 @@
 
 
 #include "BBValueProvider/BBValueProviderHolder.h"
+#include "BBValueProvider/BBValueProvider_Base.h"
 
 // Sets default values
 ABBValueProviderHolder::ABBValueProviderHolder()
@@ -11,3 +12,23 @@ ABBValueProviderHolder::ABBValueProviderHolder()
 
 }
 
+TArray<UBBValueProvider_Base*> ABBValueProviderHolder::GetProviders()
+{
+	TArray<UBBValueProvider_Base*> Providers;
+	Providers.Reserve(Values.Num());
+	for (const FInstancedStruct& Value : Values)
+	{
+		if (UBBValueProvider_Base* Provider = UBBValueProvider_Base::MakeProvider(Value, this))
+		{
+			Providers.Add(Provider);
+		}
+	}
+	return Providers;
+}
+
+void ABBValueProviderHolder::PostLoad()
+{
+	Super::PostLoad();
+
+	UBBValueProvider_Base::MigrateToValues(Providers_DEPRECATED, Values);
+}
@@ -3,13 +3,129 @@
 
 #include "BBValueProvider/BBValueProvider_Base.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Class.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Rotator.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_String.h"
 
 
+void UBBValueProvider_Base::SetBlackboardValues(UBlackboardComponent* Blackboard, TConstArrayView<UBBValueProvider_Base*> Providers)
+{
+	if (!ensureMsgf(Blackboard, TEXT("No blackboard provided!")) || Providers.IsEmpty())
+	{
+		return;
+	}
+
+	// Paused component queues each changed key once and sends them all on resume
+	Blackboard->PauseObserverNotifications();
+	for (const UBBValueProvider_Base* Provider : Providers)
+	{
+		if (Provider)
+		{
+			Provider->SetBlackboardValue(Blackboard);
+		}
+	}
+	Blackboard->ResumeObserverNotifications(true);
+}
+
+void UBBValueProvider_Base::MigrateToValues(TArray<UBBValueProvider_Base*>& Providers, TArray<FInstancedStruct>& OutValues)
+{
+	OutValues.Reserve(OutValues.Num() + Providers.Num());
+	for (const UBBValueProvider_Base* Provider : Providers)
+	{
+		if (Provider)
+		{
+			OutValues.Add(Provider->MakeValue());
+		}
+	}
+	Providers.Empty();
+}
+
+UBBValueProvider_Base* UBBValueProvider_Base::MakeProvider(const FInstancedStruct& Value, UObject* Outer)
+{
+	const UScriptStruct* Struct = Value.GetScriptStruct();
+	if (!Struct)
+	{
+		return nullptr;
+	}
+
+	UClass* ProviderClass = GetProviderClass(Struct);
+	if (!ensureMsgf(ProviderClass, TEXT("No blackboard value provider for %s, add it to GetProviderClass()"), *Struct->GetName()))
+	{
+		return nullptr;
+	}
+
+	UBBValueProvider_Base* Provider = NewObject<UBBValueProvider_Base>(Outer, ProviderClass, NAME_None, RF_Transient);
+	Provider->InitFromValue(Value);
+	return Provider;
+}
+
+UClass* UBBValueProvider_Base::GetProviderClass(const UScriptStruct* ValueStruct)
+{
+	struct FProviderPair
+	{
+		const UScriptStruct* Struct;
+		UClass* Class;
+	};
+	static const FProviderPair Pairs[] =
+	{
+		{ FBBValue_Bool::StaticStruct(), UBBValueProvider_Bool::StaticClass() },
+		{ FBBValue_Int::StaticStruct(), UBBValueProvider_Int::StaticClass() },
+		{ FBBValue_Float::StaticStruct(), UBBValueProvider_Float::StaticClass() },
+		{ FBBValue_Vector::StaticStruct(), UBBValueProvider_Vector::StaticClass() },
+		{ FBBValue_Actor::StaticStruct(), UBBValueProvider_Actor::StaticClass() },
+		{ FBBValue_Class::StaticStruct(), UBBValueProvider_Class::StaticClass() },
+		{ FBBValue_Enum::StaticStruct(), UBBValueProvider_Enum::StaticClass() },
+		{ FBBValue_Rotator::StaticStruct(), UBBValueProvider_Rotator::StaticClass() },
+		{ FBBValue_Name::StaticStruct(), UBBValueProvider_Name::StaticClass() },
+		{ FBBValue_String::StaticStruct(), UBBValueProvider_String::StaticClass() },
+	};
+
+	for (const FProviderPair& Pair : Pairs)
+	{
+		if (Pair.Struct == ValueStruct)
+		{
+			return Pair.Class;
+		}
+	}
+	return nullptr;
+}
+
+FBlackboard::FKey UBBValueProvider_Base::BindToBlackboard(const UBlackboardData& BlackboardAsset) const
+{
+	for (const FKeyBinding& Binding : KeyBindings)
+	{
+		if (Binding.Asset.Get() == &BlackboardAsset)
+		{
+			return Binding.Key;
+		}
+	}
+
+	// Drop bindings of unloaded assets before adding a new one
+	KeyBindings.RemoveAll([](const FKeyBinding& Binding) { return !Binding.Asset.IsValid(); });
+
+	const FBlackboard::FKey Key = BlackboardAsset.GetKeyID(BlackboardKeyName);
+	KeyBindings.Add({ &BlackboardAsset, Key });
+	return Key;
+}
+
+FBlackboard::FKey UBBValueProvider_Base::GetKeyID(const UBlackboardComponent& Blackboard) const
+{
+	const UBlackboardData* BlackboardAsset = Blackboard.GetBlackboardAsset();
+	return BlackboardAsset ? BindToBlackboard(*BlackboardAsset) : FBlackboard::InvalidKey;
+}
+
 void UBBValueProvider_Bool::SetBlackboardValue(UBlackboardComponent* Blackboard) const
 {
 	if (ensureMsgf(Blackboard, TEXT("No blackboard provided!")))
 	{
-		Blackboard->SetValueAsBool(BlackboardKeyName, Value);
+		Blackboard->SetValue<UBlackboardKeyType_Bool>(GetKeyID(*Blackboard), Value);
 	}
 }
 
@@ -17,7 +133,7 @@ void UBBValueProvider_Int::SetBlackboardValue(UBlackboardComponent* Blackboard)
 {
 	if (ensureMsgf(Blackboard, TEXT("No blackboard provided!")))
 	{
-		Blackboard->SetValueAsInt(BlackboardKeyName, Value);
+		Blackboard->SetValue<UBlackboardKeyType_Int>(GetKeyID(*Blackboard), Value);
 	}
 }
 
@@ -25,7 +141,7 @@ void UBBValueProvider_Float::SetBlackboardValue(UBlackboardComponent* Blackboard
 {
 	if (ensureMsgf(Blackboard, TEXT("No blackboard provided!")))
 	{
-		Blackboard->SetValueAsFloat(BlackboardKeyName, Value);
+		Blackboard->SetValue<UBlackboardKeyType_Float>(GetKeyID(*Blackboard), Value);
 	}
 }
 
@@ -33,7 +149,7 @@ void UBBValueProvider_Vector::SetBlackboardValue(UBlackboardComponent* Blackboar
 {
 	if (ensureMsgf(Blackboard, TEXT("No blackboard provided!")))
 	{
-		Blackboard->SetValueAsVector(BlackboardKeyName, Value);
+		Blackboard->SetValue<UBlackboardKeyType_Vector>(GetKeyID(*Blackboard), Value);
 	}
 }
 
@@ -43,7 +159,7 @@ void UBBValueProvider_Actor::SetBlackboardValue(UBlackboardComponent* Blackboard
 	{
 		if (Value.IsValid())
 		{
-			Blackboard->SetValueAsObject(BlackboardKeyName, Value.Get());
+			Blackboard->SetValue<UBlackboardKeyType_Object>(GetKeyID(*Blackboard), Value.Get());
 		}
 	}
 }
@@ -52,7 +168,7 @@ void UBBValueProvider_Class::SetBlackboardValue(UBlackboardComponent* Blackboard
 {
 	if (ensureMsgf(Blackboard, TEXT("No blackboard provided!")))
 	{
-		Blackboard->SetValueAsClass(BlackboardKeyName, Value);
+		Blackboard->SetValue<UBlackboardKeyType_Class>(GetKeyID(*Blackboard), Value);
 	}
 }
 
@@ -60,7 +176,7 @@ void UBBValueProvider_Enum::SetBlackboardValue(UBlackboardComponent* Blackboard)
 {
 	if (ensureMsgf(Blackboard, TEXT("No blackboard provided!")))
 	{
-		Blackboard->SetValueAsEnum(BlackboardKeyName, Value);
+		Blackboard->SetValue<UBlackboardKeyType_Enum>(GetKeyID(*Blackboard), Value);
 	}
 }
 
@@ -68,7 +184,7 @@ void UBBValueProvider_Rotator::SetBlackboardValue(UBlackboardComponent* Blackboa
 {
 	if (ensureMsgf(Blackboard, TEXT("No blackboard provided!")))
 	{
-		Blackboard->SetValueAsRotator(BlackboardKeyName, Value);
+		Blackboard->SetValue<UBlackboardKeyType_Rotator>(GetKeyID(*Blackboard), Value);
 	}
 }
 
@@ -76,7 +192,7 @@ void UBBValueProvider_Name::SetBlackboardValue(UBlackboardComponent* Blackboard)
 {
 	if (ensureMsgf(Blackboard, TEXT("No blackboard provided!")))
 	{
-		Blackboard->SetValueAsName(BlackboardKeyName, Value);
+		Blackboard->SetValue<UBlackboardKeyType_Name>(GetKeyID(*Blackboard), Value);
 	}
 }
 
@@ -84,6 +200,106 @@ void UBBValueProvider_String::SetBlackboardValue(UBlackboardComponent* Blackboar
 {
 	if (ensureMsgf(Blackboard, TEXT("No blackboard provided!")))
 	{
-		Blackboard->SetValueAsString(BlackboardKeyName, Value);
+		Blackboard->SetValue<UBlackboardKeyType_String>(GetKeyID(*Blackboard), Value);
 	}
 }
+
+FInstancedStruct UBBValueProvider_Bool::MakeValue() const
+{
+	return MakeValueStruct<FBBValue_Bool>(Value);
+}
+
+FInstancedStruct UBBValueProvider_Int::MakeValue() const
+{
+	return MakeValueStruct<FBBValue_Int>(Value);
+}
+
+FInstancedStruct UBBValueProvider_Float::MakeValue() const
+{
+	return MakeValueStruct<FBBValue_Float>(Value);
+}
+
+FInstancedStruct UBBValueProvider_Vector::MakeValue() const
+{
+	return MakeValueStruct<FBBValue_Vector>(Value);
+}
+
+FInstancedStruct UBBValueProvider_Actor::MakeValue() const
+{
+	return MakeValueStruct<FBBValue_Actor>(Value);
+}
+
+FInstancedStruct UBBValueProvider_Class::MakeValue() const
+{
+	return MakeValueStruct<FBBValue_Class>(Value);
+}
+
+FInstancedStruct UBBValueProvider_Enum::MakeValue() const
+{
+	return MakeValueStruct<FBBValue_Enum>(Value);
+}
+
+FInstancedStruct UBBValueProvider_Rotator::MakeValue() const
+{
+	return MakeValueStruct<FBBValue_Rotator>(Value);
+}
+
+FInstancedStruct UBBValueProvider_Name::MakeValue() const
+{
+	return MakeValueStruct<FBBValue_Name>(Value);
+}
+
+FInstancedStruct UBBValueProvider_String::MakeValue() const
+{
+	return MakeValueStruct<FBBValue_String>(Value);
+}
+
+void UBBValueProvider_Bool::InitFromValue(const FInstancedStruct& InValue)
+{
+	InitFromValueStruct<FBBValue_Bool>(InValue, Value);
+}
+
+void UBBValueProvider_Int::InitFromValue(const FInstancedStruct& InValue)
+{
+	InitFromValueStruct<FBBValue_Int>(InValue, Value);
+}
+
+void UBBValueProvider_Float::InitFromValue(const FInstancedStruct& InValue)
+{
+	InitFromValueStruct<FBBValue_Float>(InValue, Value);
+}
+
+void UBBValueProvider_Vector::InitFromValue(const FInstancedStruct& InValue)
+{
+	InitFromValueStruct<FBBValue_Vector>(InValue, Value);
+}
+
+void UBBValueProvider_Actor::InitFromValue(const FInstancedStruct& InValue)
+{
+	InitFromValueStruct<FBBValue_Actor>(InValue, Value);
+}
+
+void UBBValueProvider_Class::InitFromValue(const FInstancedStruct& InValue)
+{
+	InitFromValueStruct<FBBValue_Class>(InValue, Value);
+}
+
+void UBBValueProvider_Enum::InitFromValue(const FInstancedStruct& InValue)
+{
+	InitFromValueStruct<FBBValue_Enum>(InValue, Value);
+}
+
+void UBBValueProvider_Rotator::InitFromValue(const FInstancedStruct& InValue)
+{
+	InitFromValueStruct<FBBValue_Rotator>(InValue, Value);
+}
+
+void UBBValueProvider_Name::InitFromValue(const FInstancedStruct& InValue)
+{
+	InitFromValueStruct<FBBValue_Name>(InValue, Value);
+}
+
+void UBBValueProvider_String::InitFromValue(const FInstancedStruct& InValue)
+{
+	InitFromValueStruct<FBBValue_String>(InValue, Value);
+}
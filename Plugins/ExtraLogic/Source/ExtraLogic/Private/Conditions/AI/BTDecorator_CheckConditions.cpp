@@ -9,6 +9,8 @@ UBTDecorator_CheckConditions::UBTDecorator_CheckConditions()
 {
 	NodeName = "Check Conditions";
 	bCreateNodeInstance = true;
+	// Polls pending async conditions
+	bNotifyTick = true;
 }
 
 bool UBTDecorator_CheckConditions::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
@@ -18,37 +20,45 @@ bool UBTDecorator_CheckConditions::CalculateRawConditionValue(UBehaviorTreeCompo
 		return false;
 	}
 
-	bool Result = MatchType == EConditionMatchType::ANY ? false : true;
+	const AAIController* AIController = Cast<AAIController>(OwnerComp.GetOwner());
+	APawn* Owner = AIController ? AIController->GetPawn() : nullptr;
+	if (!Owner)
+	{
+		// Nothing to check against, same as every condition being skipped
+		bWaitingForResult = false;
+		return MatchType == EConditionMatchType::ALL;
+	}
 
-	for (auto const& Condition : Conditions)
+	if (!Program.IsCompiled())
 	{
-		if (Condition)
-		{
-			APawn* Owner = Cast<AAIController>(OwnerComp.GetOwner())->GetPawn();
+		Program.Compile(Conditions, MatchType);
+	}
+
+	const EConditionResult Result = Program.Poll(Owner);
+	bWaitingForResult = Result == EConditionResult::Pending;
+	if (!bWaitingForResult)
+	{
+		bLastResult = Result == EConditionResult::True;
+	}
 
-			if (!Owner)
-			{
-				continue;
-			}
+	return bLastResult;
+}
 
-			if (Condition->CheckCondition(Owner))
-			{
-				if (MatchType == EConditionMatchType::ANY)
-				{
-					return true;
-				}
-			}
-			else
-			{
-				if (MatchType == EConditionMatchType::ALL)
-				{
-					return false;
-				}
-			}
-		}
+void UBTDecorator_CheckConditions::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
+
+	if (!bWaitingForResult)
+	{
+		return;
 	}
 
-	return Result;
+	const bool bPreviousResult = bLastResult;
+	CalculateRawConditionValue(OwnerComp, NodeMemory);
+	if (!bWaitingForResult && bLastResult != bPreviousResult)
+	{
+		ConditionalFlowAbort(OwnerComp, EBTDecoratorAbortRequest::ConditionResultChanged);
+	}
 }
 
 FString UBTDecorator_CheckConditions::GetStaticDescription() const
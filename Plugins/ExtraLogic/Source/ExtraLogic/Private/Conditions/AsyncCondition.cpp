@@ -0,0 +1,92 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+
+#include "Conditions/AsyncCondition.h"
+#include "Engine/World.h"
+
+/** Number of tracked contexts above which finished states get pruned */
+static constexpr int32 StatesPruneThreshold = 64;
+
+
+UAsyncBaseCondition::UAsyncBaseCondition()
+{
+	CostHint = 10;
+}
+
+void UAsyncBaseCondition::FinishCondition(UObject* Context, bool bResult) const
+{
+	check(IsInGameThread());
+
+	FAsyncState& State = States.FindOrAdd(Context);
+	State.bRunning = false;
+	State.bResult = bResult;
+	State.FinishTime = GetTimeSeconds();
+}
+
+EConditionResult UAsyncBaseCondition::AsyncCondition(UObject* Context) const
+{
+	const double Now = GetTimeSeconds();
+	if (const FAsyncState* State = States.Find(Context))
+	{
+		if (State->bRunning)
+		{
+			return EConditionResult::Pending;
+		}
+		if (State->FinishTime >= 0.0 && Now - State->FinishTime <= ResultLifetime)
+		{
+			return State->bResult ? EConditionResult::True : EConditionResult::False;
+		}
+	}
+	else if (States.Num() >= StatesPruneThreshold)
+	{
+		PruneStates(Now);
+	}
+
+	States.FindOrAdd(Context).bRunning = true;
+	StartCondition(Context);
+
+	// Could have been finished right away
+	const FAsyncState& State = States.FindChecked(Context);
+	if (State.bRunning)
+	{
+		return EConditionResult::Pending;
+	}
+	return State.bResult ? EConditionResult::True : EConditionResult::False;
+}
+
+bool UAsyncBaseCondition::Condition(UObject* Context) const
+{
+	const FAsyncState* LastState = States.Find(Context);
+	const bool bLastResult = LastState && LastState->FinishTime >= 0.0 && LastState->bResult;
+
+	const EConditionResult Result = AsyncCondition(Context);
+	return Result == EConditionResult::Pending ? bLastResult : Result == EConditionResult::True;
+}
+
+double UAsyncBaseCondition::GetTimeSeconds() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : FPlatformTime::Seconds();
+}
+
+void UAsyncBaseCondition::PruneStates(double Now) const
+{
+	for (auto It = States.CreateIterator(); It; ++It)
+	{
+		const bool bExpired = !It->Value.bRunning && Now - It->Value.FinishTime > ResultLifetime;
+		if (bExpired || !It->Key.ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UBlueprintAsyncCondition::K2_FinishCondition(UObject* Context, bool bResult) const
+{
+	FinishCondition(Context, bResult);
+}
+
+void UBlueprintAsyncCondition::StartCondition(UObject* Context) const
+{
+	K2_StartCondition(Context);
+}
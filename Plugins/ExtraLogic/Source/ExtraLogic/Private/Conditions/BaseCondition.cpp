@@ -9,6 +9,29 @@ bool UBaseCondition::CheckCondition(UObject* Context) const
 	return bInversed ? !Condition(Context) : Condition(Context);
 }
 
+EConditionResult UBaseCondition::PollCondition(UObject* Context) const
+{
+	const EConditionResult Result = AsyncCondition(Context);
+	if (Result == EConditionResult::Pending || !bInversed)
+	{
+		return Result;
+	}
+	return Result == EConditionResult::True ? EConditionResult::False : EConditionResult::True;
+}
+
+double UBaseCondition::GetCacheLifetime() const
+{
+	switch (Volatility)
+	{
+	case EConditionVolatility::Pure:
+		return TNumericLimits<double>::Max();
+	case EConditionVolatility::Timed:
+		return FMath::Max(0.f, CacheLifetime);
+	default:
+		return 0.0;
+	}
+}
+
 UWorld* UBaseCondition::GetWorld() const
 {
 	UObject* Outer = GetOuter();
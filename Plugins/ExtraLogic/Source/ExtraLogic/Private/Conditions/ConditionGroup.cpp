@@ -0,0 +1,51 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+
+#include "Conditions/ConditionGroup.h"
+
+
+UConditionGroup::UConditionGroup()
+{
+	ConditionName = "Condition Group";
+}
+
+int32 UConditionGroup::GetCostHint() const
+{
+	int32 Cost = 0;
+	for (const UBaseCondition* Condition : Conditions)
+	{
+		if (Condition)
+		{
+			Cost += Condition->GetCostHint();
+		}
+	}
+	return Cost;
+}
+
+bool UConditionGroup::Condition(UObject* Context) const
+{
+	for (const UBaseCondition* Condition : Conditions)
+	{
+		if (!Condition)
+		{
+			continue;
+		}
+
+		if (Condition->CheckCondition(Context))
+		{
+			if (MatchType == EConditionMatchType::ANY)
+			{
+				return true;
+			}
+		}
+		else
+		{
+			if (MatchType == EConditionMatchType::ALL)
+			{
+				return false;
+			}
+		}
+	}
+
+	return MatchType == EConditionMatchType::ALL;
+}
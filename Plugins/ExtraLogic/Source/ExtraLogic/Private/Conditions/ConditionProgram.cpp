@@ -0,0 +1,213 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+
+#include "Conditions/ConditionProgram.h"
+#include "Conditions/ConditionGroup.h"
+#include "Algo/StableSort.h"
+
+/** Guards against groups referencing each other */
+static constexpr int32 MaxGroupDepth = 32;
+
+
+void FConditionProgram::Compile(TConstArrayView<UBaseCondition*> Conditions, EConditionMatchType MatchType)
+{
+	Reset();
+
+	FCompiler Compiler{ Instructions, Leaves };
+	// Labels 0 and 1 are the program results
+	Compiler.LabelTargets = { ReturnTrue, ReturnFalse };
+	Compiler.EmitList(Conditions, MatchType, 0, 1, 0);
+
+	const int32 MaxIndex = TNumericLimits<int16>::Max();
+	if (!ensureMsgf(Instructions.Num() <= MaxIndex && Compiler.LabelTargets.Num() <= MaxIndex, TEXT("Condition program is too large")))
+	{
+		Reset();
+		// Falls back to an unconditional failure
+		Instructions.Add({ nullptr, ReturnFalse, ReturnFalse });
+		return;
+	}
+
+	Compiler.Resolve();
+
+	bHasAsyncConditions = Leaves.ContainsByPredicate([](const UBaseCondition* Condition) { return Condition->IsAsync(); });
+}
+
+void FConditionProgram::Reset()
+{
+	Instructions.Reset();
+	Leaves.Reset();
+	bHasAsyncConditions = false;
+}
+
+bool FConditionProgram::Evaluate(UObject* Context) const
+{
+	int32 Index = 0;
+	while (Instructions.IsValidIndex(Index))
+	{
+		const FInstruction& Instruction = Instructions[Index];
+		const bool bResult = !Instruction.Condition || Instruction.Condition->CheckCondition(Context);
+		const int16 Next = bResult ? Instruction.OnTrue : Instruction.OnFalse;
+		if (Next < 0)
+		{
+			return Next == ReturnTrue;
+		}
+		Index = Next;
+	}
+
+	ensureMsgf(false, TEXT("Evaluating condition program that isn't compiled"));
+	return false;
+}
+
+EConditionResult FConditionProgram::Poll(UObject* Context) const
+{
+	if (!bHasAsyncConditions)
+	{
+		return Evaluate(Context) ? EConditionResult::True : EConditionResult::False;
+	}
+
+	if (!ensureMsgf(IsCompiled(), TEXT("Polling condition program that isn't compiled")))
+	{
+		return EConditionResult::False;
+	}
+
+	// Pending leaf is unknown, so both of its branches are followed. Jumps only go forward,
+	// so a single pass in order visits every instruction reachable by some outcome of the pending ones
+	TBitArray<> Reached(false, Instructions.Num());
+	Reached[0] = true;
+	bool bReachedTrue = false;
+	bool bReachedFalse = false;
+
+	const auto Follow = [&](int16 Next)
+	{
+		if (Next == ReturnTrue)
+		{
+			bReachedTrue = true;
+		}
+		else if (Next == ReturnFalse)
+		{
+			bReachedFalse = true;
+		}
+		else
+		{
+			Reached[Next] = true;
+		}
+	};
+
+	for (int32 Index = 0; Index < Instructions.Num(); ++Index)
+	{
+		if (!Reached[Index])
+		{
+			continue;
+		}
+
+		// Once both results are possible the program is Pending whatever the rest returns,
+		// remaining sync leaves are skipped as unknown and only async ones get started
+		const FInstruction& Instruction = Instructions[Index];
+		const bool bUndetermined = bReachedTrue && bReachedFalse;
+		EConditionResult Result = EConditionResult::True;
+		if (Instruction.Condition)
+		{
+			Result = bUndetermined && !Instruction.Condition->IsAsync() ? EConditionResult::Pending : Instruction.Condition->PollCondition(Context);
+		}
+
+		if (Result != EConditionResult::False)
+		{
+			Follow(Instruction.OnTrue);
+		}
+		if (Result != EConditionResult::True)
+		{
+			Follow(Instruction.OnFalse);
+		}
+	}
+
+	if (bReachedTrue && bReachedFalse)
+	{
+		return EConditionResult::Pending;
+	}
+	return bReachedTrue ? EConditionResult::True : EConditionResult::False;
+}
+
+double FConditionProgram::GetCacheLifetime() const
+{
+	double Lifetime = TNumericLimits<double>::Max();
+	for (const UBaseCondition* Condition : Leaves)
+	{
+		Lifetime = FMath::Min(Lifetime, Condition->GetCacheLifetime());
+	}
+	return Lifetime;
+}
+
+int32 FConditionProgram::FCompiler::NewLabel()
+{
+	return LabelTargets.Add(INDEX_NONE);
+}
+
+void FConditionProgram::FCompiler::BindLabel(int32 Label)
+{
+	LabelTargets[Label] = Instructions.Num();
+}
+
+void FConditionProgram::FCompiler::EmitList(TConstArrayView<UBaseCondition*> Conditions, EConditionMatchType MatchType, int32 TrueLabel, int32 FalseLabel, int32 Depth)
+{
+	TArray<const UBaseCondition*, TInlineAllocator<16>> Sorted;
+	for (const UBaseCondition* Condition : Conditions)
+	{
+		if (Condition)
+		{
+			Sorted.Add(Condition);
+		}
+	}
+	Algo::StableSortBy(Sorted, [](const UBaseCondition* Condition) { return Condition->GetCostHint(); });
+
+	if (Sorted.IsEmpty())
+	{
+		const int32 Label = MatchType == EConditionMatchType::ALL ? TrueLabel : FalseLabel;
+		Instructions.Add({ nullptr, int16(Label), int16(Label) });
+		return;
+	}
+
+	// ALL: failure exits early, success falls through to the next one. ANY is the opposite
+	for (int32 i = 0; i < Sorted.Num(); ++i)
+	{
+		const bool bLast = i == Sorted.Num() - 1;
+		const int32 NextLabel = bLast ? INDEX_NONE : NewLabel();
+		if (MatchType == EConditionMatchType::ALL)
+		{
+			EmitCondition(Sorted[i], bLast ? TrueLabel : NextLabel, FalseLabel, Depth);
+		}
+		else
+		{
+			EmitCondition(Sorted[i], TrueLabel, bLast ? FalseLabel : NextLabel, Depth);
+		}
+
+		if (!bLast)
+		{
+			BindLabel(NextLabel);
+		}
+	}
+}
+
+void FConditionProgram::FCompiler::EmitCondition(const UBaseCondition* Condition, int32 TrueLabel, int32 FalseLabel, int32 Depth)
+{
+	if (const UConditionGroup* Group = Cast<UConditionGroup>(Condition); Group && Depth < MaxGroupDepth)
+	{
+		if (Group->IsInversed())
+		{
+			Swap(TrueLabel, FalseLabel);
+		}
+		EmitList(Group->GetConditions(), Group->GetMatchType(), TrueLabel, FalseLabel, Depth + 1);
+		return;
+	}
+
+	Leaves.AddUnique(Condition);
+	Instructions.Add({ Condition, int16(TrueLabel), int16(FalseLabel) });
+}
+
+void FConditionProgram::FCompiler::Resolve()
+{
+	for (FInstruction& Instruction : Instructions)
+	{
+		Instruction.OnTrue = int16(LabelTargets[Instruction.OnTrue]);
+		Instruction.OnFalse = int16(LabelTargets[Instruction.OnFalse]);
+	}
+}
@@ -0,0 +1,199 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+
+#include "Conditions/NativeConditions.h"
+#include "GameplayTagAssetInterface.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType.h"
+#include "Blueprint/AIBlueprintHelperLibrary.h"
+
+
+namespace NativeConditions
+{
+	/** Controllers are resolved to their pawns */
+	static AActor* GetAgent(UObject* Context)
+	{
+		if (AController* Controller = Cast<AController>(Context))
+		{
+			if (APawn* Pawn = Controller->GetPawn())
+			{
+				return Pawn;
+			}
+			return Controller;
+		}
+		return Cast<AActor>(Context);
+	}
+}
+
+// Gameplay Tag Query
+
+UCondition_GameplayTagQuery::UCondition_GameplayTagQuery()
+{
+	ConditionName = "Gameplay Tag Query";
+	// Owned tags are copied, query can't be evaluated against the interface directly
+	CostHint = 3;
+}
+
+bool UCondition_GameplayTagQuery::Condition(UObject* Context) const
+{
+	const IGameplayTagAssetInterface* TagInterface = Cast<IGameplayTagAssetInterface>(NativeConditions::GetAgent(Context));
+	if (!TagInterface)
+	{
+		return false;
+	}
+
+	// Reused, so only the first checks of a thread allocate
+	static thread_local FGameplayTagContainer Tags;
+	Tags.Reset();
+	TagInterface->GetOwnedGameplayTags(Tags);
+	return TagQuery.Matches(Tags);
+}
+
+// Distance Band
+
+UCondition_DistanceBand::UCondition_DistanceBand()
+{
+	ConditionName = "Distance Band";
+	// Two locations and a comparison
+	CostHint = 1;
+}
+
+bool UCondition_DistanceBand::Condition(UObject* Context) const
+{
+	const AActor* Agent = NativeConditions::GetAgent(Context);
+	const AActor* Target = GetOwner() ? GetOwner() : GetTypedOuter<AActor>();
+	if (!Agent || !Target)
+	{
+		return false;
+	}
+
+	const FVector Delta = Agent->GetActorLocation() - Target->GetActorLocation();
+	const double DistSq = bIgnoreZ ? Delta.SizeSquared2D() : Delta.SizeSquared();
+	return DistSq >= FMath::Square(double(MinDistance)) && DistSq <= FMath::Square(double(MaxDistance));
+}
+
+// Blackboard Compare
+
+UCondition_BlackboardCompare::UCondition_BlackboardCompare()
+{
+	ConditionName = "Blackboard Compare";
+	CostHint = 2;
+}
+
+bool UCondition_BlackboardCompare::Condition(UObject* Context) const
+{
+	const UBlackboardComponent* BB = UAIBlueprintHelperLibrary::GetBlackboard(Cast<AActor>(Context));
+	if (!BB || !BB->GetBlackboardAsset())
+	{
+		return false;
+	}
+
+	const FBlackboard::FKey KeyID = GetKeyID(*BB->GetBlackboardAsset());
+	const FBlackboardEntry* Entry = BB->GetBlackboardAsset()->GetKey(KeyID);
+	if (!Entry || !Entry->KeyType)
+	{
+		return false;
+	}
+
+	const uint8* RawData = BB->GetKeyRawData(KeyID);
+	switch (Operation)
+	{
+	case EBlackboardCompareOp::IsSet:
+		return Entry->KeyType->WrappedTestBasicOperation(*BB, RawData, EBasicKeyOperation::Set);
+	case EBlackboardCompareOp::IsNotSet:
+		return Entry->KeyType->WrappedTestBasicOperation(*BB, RawData, EBasicKeyOperation::NotSet);
+	default:
+		break;
+	}
+
+	if (Entry->KeyType->GetTestOperation() != EBlackboardKeyOperation::Arithmetic)
+	{
+		return false;
+	}
+
+	EArithmeticKeyOperation::Type ArithmeticOp = EArithmeticKeyOperation::Equal;
+	switch (Operation)
+	{
+	case EBlackboardCompareOp::NotEqual:		ArithmeticOp = EArithmeticKeyOperation::NotEqual; break;
+	case EBlackboardCompareOp::Less:			ArithmeticOp = EArithmeticKeyOperation::Less; break;
+	case EBlackboardCompareOp::LessOrEqual:		ArithmeticOp = EArithmeticKeyOperation::LessOrEqual; break;
+	case EBlackboardCompareOp::Greater:			ArithmeticOp = EArithmeticKeyOperation::Greater; break;
+	case EBlackboardCompareOp::GreaterOrEqual:	ArithmeticOp = EArithmeticKeyOperation::GreaterOrEqual; break;
+	default: break;
+	}
+
+	return Entry->KeyType->WrappedTestArithmeticOperation(*BB, RawData, ArithmeticOp, FMath::RoundToInt(Value), Value);
+}
+
+FBlackboard::FKey UCondition_BlackboardCompare::GetKeyID(const UBlackboardData& BlackboardAsset) const
+{
+	for (const FKeyBinding& Binding : KeyBindings)
+	{
+		if (Binding.Asset.Get() == &BlackboardAsset)
+		{
+			return Binding.Key;
+		}
+	}
+
+	// Drop bindings of unloaded assets before adding a new one
+	KeyBindings.RemoveAll([](const FKeyBinding& Binding) { return !Binding.Asset.IsValid(); });
+
+	const FBlackboard::FKey Key = BlackboardAsset.GetKeyID(KeyName);
+	KeyBindings.Add({ &BlackboardAsset, Key });
+	return Key;
+}
+
+// Time Of Day
+
+UCondition_TimeOfDay::UCondition_TimeOfDay()
+{
+	ConditionName = "Time Of Day Window";
+	// Hour changes slowly, no need to check it every time
+	Volatility = EConditionVolatility::Timed;
+	CacheLifetime = 1.f;
+}
+
+bool UCondition_TimeOfDay::Condition(UObject* Context) const
+{
+	double Hour = 0.0;
+	if (Source == ETimeOfDaySource::SystemClock)
+	{
+		const FDateTime Now = FDateTime::Now();
+		Hour = Now.GetHour() + Now.GetMinute() / 60.0;
+	}
+	else
+	{
+		const UWorld* World = GetWorld();
+		if (!World)
+		{
+			return false;
+		}
+		Hour = FMath::Fmod(World->GetTimeSeconds(), double(DayLength)) / DayLength * 24.0;
+	}
+
+	return StartHour <= EndHour
+		? Hour >= StartHour && Hour < EndHour
+		: Hour >= StartHour || Hour < EndHour;
+}
+
+// Actor Class
+
+UCondition_ActorClass::UCondition_ActorClass()
+{
+	ConditionName = "Actor Class";
+	Volatility = EConditionVolatility::Pure;
+}
+
+bool UCondition_ActorClass::Condition(UObject* Context) const
+{
+	const AActor* Agent = NativeConditions::GetAgent(Context);
+	if (!Agent || !ActorClass)
+	{
+		return false;
+	}
+
+	return bExactMatch ? Agent->GetClass() == ActorClass : Agent->IsA(ActorClass);
+}
@@ -0,0 +1,207 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StructUtils/InstancedStruct.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BBValue.generated.h"
+
+class UBlackboardComponent;
+
+/**
+ *	Plain data counterpart of UBBValueProvider_Base. Meant to be stored in
+ *	TArray<FInstancedStruct> with meta = (BaseStruct = "/Script/ExtraLogic.BBValue", ExcludeBaseStruct),
+ *	which gives the same type picker as Instanced providers, without a UObject per value.
+ *
+ *	BlackboardKeyName is resolved once per blackboard asset and cached, like in providers.
+ *	@see UBBValueProvider_Base::MakeValue for migrating existing providers
+ */
+USTRUCT(BlueprintType)
+struct EXTRALOGIC_API FBBValue
+{
+	GENERATED_BODY()
+
+public:
+	virtual ~FBBValue() = default;
+
+	/** Writes the value to the key of the blackboard */
+	void SetBlackboardValue(UBlackboardComponent& Blackboard) const;
+	/** Writes all values as one transaction, see UBBValueProvider_Base::SetBlackboardValues */
+	static void SetBlackboardValues(UBlackboardComponent* Blackboard, TConstArrayView<FInstancedStruct> Values);
+
+	/** Cached key of BlackboardKeyName in the component's asset */
+	FBlackboard::FKey GetKeyID(const UBlackboardComponent& Blackboard) const;
+
+	/** */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
+	FName BlackboardKeyName;
+
+protected:
+	/** Each derived struct must override this to handle a value of its specific type */
+	virtual void SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const {}
+
+private:
+	mutable TWeakObjectPtr<const UBlackboardData> BoundAsset;
+	mutable FBlackboard::FKey BoundKey = FBlackboard::InvalidKey;
+};
+
+/**
+ *	Bool
+ */
+USTRUCT(BlueprintType, meta = (DisplayName = "Bool"))
+struct EXTRALOGIC_API FBBValue_Bool : public FBBValue
+{
+	GENERATED_BODY()
+
+	/** */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
+	bool Value = false;
+
+protected:
+	virtual void SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const override;
+};
+
+/**
+ *	Integer
+ */
+USTRUCT(BlueprintType, meta = (DisplayName = "Int"))
+struct EXTRALOGIC_API FBBValue_Int : public FBBValue
+{
+	GENERATED_BODY()
+
+	/** */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
+	int32 Value = 0;
+
+protected:
+	virtual void SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const override;
+};
+
+/**
+ *	Float
+ */
+USTRUCT(BlueprintType, meta = (DisplayName = "Float"))
+struct EXTRALOGIC_API FBBValue_Float : public FBBValue
+{
+	GENERATED_BODY()
+
+	/** */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
+	float Value = 0.f;
+
+protected:
+	virtual void SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const override;
+};
+
+/**
+ *	Vector
+ */
+USTRUCT(BlueprintType, meta = (DisplayName = "Vector"))
+struct EXTRALOGIC_API FBBValue_Vector : public FBBValue
+{
+	GENERATED_BODY()
+
+	/** */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
+	FVector Value = FVector::ZeroVector;
+
+protected:
+	virtual void SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const override;
+};
+
+/**
+ *	Actor
+ */
+USTRUCT(BlueprintType, meta = (DisplayName = "Actor"))
+struct EXTRALOGIC_API FBBValue_Actor : public FBBValue
+{
+	GENERATED_BODY()
+
+	/** */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
+	TSoftObjectPtr<AActor> Value;
+
+protected:
+	virtual void SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const override;
+};
+
+/**
+ *	Class
+ */
+USTRUCT(BlueprintType, meta = (DisplayName = "Class"))
+struct EXTRALOGIC_API FBBValue_Class : public FBBValue
+{
+	GENERATED_BODY()
+
+	/** */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
+	UClass* Value = nullptr;
+
+protected:
+	virtual void SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const override;
+};
+
+/**
+ *	Enum
+ */
+USTRUCT(BlueprintType, meta = (DisplayName = "Enum"))
+struct EXTRALOGIC_API FBBValue_Enum : public FBBValue
+{
+	GENERATED_BODY()
+
+	/** */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
+	uint8 Value = 0;
+
+protected:
+	virtual void SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const override;
+};
+
+/**
+ *	Rotator
+ */
+USTRUCT(BlueprintType, meta = (DisplayName = "Rotator"))
+struct EXTRALOGIC_API FBBValue_Rotator : public FBBValue
+{
+	GENERATED_BODY()
+
+	/** */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
+	FRotator Value = FRotator::ZeroRotator;
+
+protected:
+	virtual void SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const override;
+};
+
+/**
+ *	Name
+ */
+USTRUCT(BlueprintType, meta = (DisplayName = "Name"))
+struct EXTRALOGIC_API FBBValue_Name : public FBBValue
+{
+	GENERATED_BODY()
+
+	/** */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
+	FName Value;
+
+protected:
+	virtual void SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const override;
+};
+
+/**
+ *	String
+ */
+USTRUCT(BlueprintType, meta = (DisplayName = "String"))
+struct EXTRALOGIC_API FBBValue_String : public FBBValue
+{
+	GENERATED_BODY()
+
+	/** */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
+	FString Value;
+
+protected:
+	virtual void SetValue(UBlackboardComponent& Blackboard, FBlackboard::FKey Key) const override;
+};
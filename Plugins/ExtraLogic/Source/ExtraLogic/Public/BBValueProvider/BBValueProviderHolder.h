@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "StructUtils/InstancedStruct.h"
 #include "BBValueProviderHolder.generated.h"
 
 class UBBValueProvider_Base;
@@ -17,7 +18,20 @@ public:
 	// Sets default values for this actor's properties
 	ABBValueProviderHolder();
 
+	/** */
+	const TArray<FInstancedStruct>& GetValues() const { return Values; }
+	/** Values as transient providers, keeps Blueprints written before Values replaced Providers working. Created on every call, so it isn't pure */
+	UFUNCTION(BlueprintCallable, Category = "Blackboard", meta = (DisplayName = "Providers", DeprecatedFunction, DeprecationMessage = "Use Values instead"))
+	TArray<UBBValueProvider_Base*> GetProviders();
+
 protected:
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Instanced, meta=(ShowOnlyInnerProperties))
-	TArray<UBBValueProvider_Base*> Providers;
+	/** Migrates old Instanced providers to Values */
+	virtual void PostLoad() override;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, meta = (BaseStruct = "/Script/ExtraLogic.BBValue", ExcludeBaseStruct))
+	TArray<FInstancedStruct> Values;
+
+private:
+	UPROPERTY(Instanced)
+	TArray<UBBValueProvider_Base*> Providers_DEPRECATED;
 };
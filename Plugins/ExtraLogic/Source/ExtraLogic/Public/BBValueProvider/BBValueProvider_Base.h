@@ -4,12 +4,20 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BBValueProvider/BBValue.h"
 #include "BBValueProvider_Base.generated.h"
 
 /**
  *	Blackboard value providers are meant to simplify setting up values
  *  for Behavior Trees' blackboards by gathering types under one parent class.
  *	Value providers are meant to be used as Instanced objects in TArrays.
+ *
+ *	BlackboardKeyName is resolved to a key once per blackboard asset and cached,
+ *	so setting values doesn't involve name lookups.
+ *
+ *	Every provider is a separate UObject, so large amounts of them add GC and load costs.
+ *	Prefer FBBValue structs for data stored in levels, MakeValue() converts existing providers.
  *	@see BBValueProviderHolder
  */
  class UBlackboardComponent;
@@ -24,13 +32,68 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Blackboard", meta = (DisplayName = "SetBlackboardValue"))
 	void K2_SetBlackboardValue(UBlackboardComponent* Blackboard) const { SetBlackboardValue(Blackboard); }
 
+	/**
+	 *	Sets values of all providers as one transaction: observers are notified once per changed key
+	 *	after everything is written, so decorators don't re-evaluate for every single write.
+	 */
+	static void SetBlackboardValues(UBlackboardComponent* Blackboard, TConstArrayView<UBBValueProvider_Base*> Providers);
+	/** Blueprint callable batch setter. */
+	UFUNCTION(BlueprintCallable, Category = "Blackboard", meta = (DisplayName = "SetBlackboardValues"))
+	static void K2_SetBlackboardValues(UBlackboardComponent* Blackboard, const TArray<UBBValueProvider_Base*>& Providers) { SetBlackboardValues(Blackboard, Providers); }
+
 	/** Main setter function. Each derived class must override this to handle a value of its specific type. */
 	virtual void SetBlackboardValue(UBlackboardComponent* Blackboard) const PURE_VIRTUAL(UBBValueProvider_Base::SetBlackboardValue, );
 
+	/** Plain data copy of this provider, see FBBValue */
+	virtual FInstancedStruct MakeValue() const PURE_VIRTUAL(UBBValueProvider_Base::MakeValue, return FInstancedStruct(););
+	/** Appends MakeValue() of every provider to OutValues and empties Providers. Meant for PostLoad() migrations */
+	static void MigrateToValues(TArray<UBBValueProvider_Base*>& Providers, TArray<FInstancedStruct>& OutValues);
+	/** Transient provider holding the FBBValue, opposite of MakeValue(). Null if there's no provider of the value's type */
+	static UBBValueProvider_Base* MakeProvider(const FInstancedStruct& Value, UObject* Outer);
+	/** FBBValue struct MakeValue() of this provider class returns, pairs are listed next to MakeProvider() */
+	static UClass* GetProviderClass(const UScriptStruct* ValueStruct);
+
+	/** Resolves the key for the asset ahead of time, otherwise it happens on the first set */
+	FBlackboard::FKey BindToBlackboard(const UBlackboardData& BlackboardAsset) const;
+	/** Cached key of BlackboardKeyName in the component's asset */
+	FBlackboard::FKey GetKeyID(const UBlackboardComponent& Blackboard) const;
+
 protected:
+	/** FBBValue struct of type T with this provider's key, shared by MakeValue() overrides */
+	template<typename T, typename TValue>
+	FInstancedStruct MakeValueStruct(const TValue& InValue) const
+	{
+		T BBValue;
+		BBValue.BlackboardKeyName = BlackboardKeyName;
+		BBValue.Value = InValue;
+		return FInstancedStruct::Make(BBValue);
+	}
+
+	/** Takes key and value of FBBValue struct of type T, shared by InitFromValue() overrides */
+	template<typename T, typename TValue>
+	void InitFromValueStruct(const FInstancedStruct& InStruct, TValue& OutValue)
+	{
+		const T& BBValue = InStruct.Get<T>();
+		BlackboardKeyName = BBValue.BlackboardKeyName;
+		OutValue = BBValue.Value;
+	}
+
+	/** Opposite of MakeValue(), Value is of the struct type paired with the class. @see MakeProvider() */
+	virtual void InitFromValue(const FInstancedStruct& Value) PURE_VIRTUAL(UBBValueProvider_Base::InitFromValue, );
+
 	/** */
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
 	FName BlackboardKeyName;
+
+private:
+	struct FKeyBinding
+	{
+		TWeakObjectPtr<const UBlackboardData> Asset;
+		FBlackboard::FKey Key;
+	};
+
+	/** Agents rarely use more than one blackboard asset */
+	mutable TArray<FKeyBinding, TInlineAllocator<1>> KeyBindings;
 };
 
 /**
@@ -43,8 +106,11 @@ class EXTRALOGIC_API UBBValueProvider_Bool : public UBBValueProvider_Base
 
 public:
 	void SetBlackboardValue(UBlackboardComponent* Blackboard) const override;
+	FInstancedStruct MakeValue() const override;
 
 protected:
+	void InitFromValue(const FInstancedStruct& InValue) override;
+
 	/** */
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
 	bool Value;
@@ -60,8 +126,11 @@ class EXTRALOGIC_API UBBValueProvider_Int : public UBBValueProvider_Base
 
 public:
 	void SetBlackboardValue(UBlackboardComponent* Blackboard) const override;
+	FInstancedStruct MakeValue() const override;
 
 protected:
+	void InitFromValue(const FInstancedStruct& InValue) override;
+
 	/** */
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
 	int32 Value;
@@ -77,8 +146,11 @@ class EXTRALOGIC_API UBBValueProvider_Float : public UBBValueProvider_Base
 
 public:
 	void SetBlackboardValue(UBlackboardComponent* Blackboard) const override;
+	FInstancedStruct MakeValue() const override;
 
 protected:
+	void InitFromValue(const FInstancedStruct& InValue) override;
+
 	/** */
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
 	float Value;
@@ -94,8 +166,11 @@ class EXTRALOGIC_API UBBValueProvider_Vector : public UBBValueProvider_Base
 
 public:
 	void SetBlackboardValue(UBlackboardComponent* Blackboard) const override;
+	FInstancedStruct MakeValue() const override;
 
 protected:
+	void InitFromValue(const FInstancedStruct& InValue) override;
+
 	/** */
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
 	FVector Value;
@@ -111,8 +186,11 @@ class EXTRALOGIC_API UBBValueProvider_Actor : public UBBValueProvider_Base
 
 public:
 	void SetBlackboardValue(UBlackboardComponent* Blackboard) const override;
+	FInstancedStruct MakeValue() const override;
 
 protected:
+	void InitFromValue(const FInstancedStruct& InValue) override;
+
 	/** */
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
 	TSoftObjectPtr<AActor> Value;
@@ -128,8 +206,11 @@ class EXTRALOGIC_API UBBValueProvider_Class : public UBBValueProvider_Base
 
 public:
 	void SetBlackboardValue(UBlackboardComponent* Blackboard) const override;
+	FInstancedStruct MakeValue() const override;
 
 protected:
+	void InitFromValue(const FInstancedStruct& InValue) override;
+
 	/** */
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
 	UClass* Value;
@@ -145,8 +226,11 @@ class EXTRALOGIC_API UBBValueProvider_Enum : public UBBValueProvider_Base
 
 public:
 	void SetBlackboardValue(UBlackboardComponent* Blackboard) const override;
+	FInstancedStruct MakeValue() const override;
 
 protected:
+	void InitFromValue(const FInstancedStruct& InValue) override;
+
 	/** */
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
 	uint8 Value;
@@ -162,8 +246,11 @@ class EXTRALOGIC_API UBBValueProvider_Rotator : public UBBValueProvider_Base
 
 public:
 	void SetBlackboardValue(UBlackboardComponent* Blackboard) const override;
+	FInstancedStruct MakeValue() const override;
 
 protected:
+	void InitFromValue(const FInstancedStruct& InValue) override;
+
 	/** */
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
 	FRotator Value;
@@ -179,8 +266,11 @@ class EXTRALOGIC_API UBBValueProvider_Name : public UBBValueProvider_Base
 
 public:
 	void SetBlackboardValue(UBlackboardComponent* Blackboard) const override;
+	FInstancedStruct MakeValue() const override;
 
 protected:
+	void InitFromValue(const FInstancedStruct& InValue) override;
+
 	/** */
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
 	FName Value;
@@ -196,8 +286,11 @@ class EXTRALOGIC_API UBBValueProvider_String : public UBBValueProvider_Base
 
 public:
 	void SetBlackboardValue(UBlackboardComponent* Blackboard) const override;
+	FInstancedStruct MakeValue() const override;
 
 protected:
+	void InitFromValue(const FInstancedStruct& InValue) override;
+
 	/** */
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Blackboard")
 	FString Value;
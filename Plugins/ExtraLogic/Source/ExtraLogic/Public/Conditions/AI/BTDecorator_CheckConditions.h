@@ -5,10 +5,15 @@
 #include "CoreMinimal.h"
 #include "BehaviorTree/BTDecorator.h"
 #include "Conditions/BaseCondition.h"
+#include "Conditions/ConditionProgram.h"
 #include "BTDecorator_CheckConditions.generated.h"
 
 /**
  *	Allows execution flow when provided conditions are met for the possesed Pawn.
+ *
+ *	Async conditions don't block: while they are pending the last known result is used
+ *	and the node polls them on tick. Once the result arrives and differs, flow abort is
+ *	requested, so set FlowAbortMode for the tree to react.
  */
 
 UCLASS()
@@ -21,10 +26,18 @@ public:
 	
 protected:
 	virtual bool CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const override;
+	virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
 	virtual FString GetStaticDescription() const override;
 
 	UPROPERTY(EditAnywhere, Category = "CheckConditions")
 	EConditionMatchType MatchType;
 	UPROPERTY(EditAnywhere, Category = "CheckConditions", Instanced)
 	TArray<UBaseCondition*> Conditions;
+
+	/** Compiled on first check, node is instanced so every instance has its own */
+	mutable FConditionProgram Program;
+	/** Result returned while async conditions are pending */
+	mutable bool bLastResult = false;
+	/** Whether the last evaluation was pending, polled on tick */
+	mutable bool bWaitingForResult = false;
 };
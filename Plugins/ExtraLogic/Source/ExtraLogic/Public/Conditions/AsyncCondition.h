@@ -0,0 +1,73 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Conditions/BaseCondition.h"
+#include "AsyncCondition.generated.h"
+
+/**
+ *	Base class for conditions that can't be answered right away, e.g. async traces.
+ *
+ *	The first PollCondition() for a context calls StartCondition() and returns Pending
+ *	until FinishCondition() is called for that context. Finished result is then reused
+ *	for ResultLifetime seconds, so users re-polling a whole condition list don't restart it.
+ *
+ *	Synchronous CheckCondition() can't wait, it returns the last finished result
+ *	(false if there's none) and starts a new evaluation if needed.
+ *
+ *	@see FConditionProgram::Poll
+ */
+UCLASS(Abstract)
+class EXTRALOGIC_API UAsyncBaseCondition : public UBaseCondition
+{
+	GENERATED_BODY()
+
+public:
+	UAsyncBaseCondition();
+
+	virtual bool IsAsync() const override { return true; }
+	/** Completes evaluation for the context, game thread only. May be called from within StartCondition() */
+	void FinishCondition(UObject* Context, bool bResult) const;
+
+protected:
+	/** Starts evaluation for the context, FinishCondition() has to be called eventually */
+	virtual void StartCondition(UObject* Context) const PURE_VIRTUAL(UAsyncBaseCondition::StartCondition, );
+
+	virtual EConditionResult AsyncCondition(UObject* Context) const override;
+	virtual bool Condition(UObject* Context) const override;
+
+	/** For how long a finished result is reused before evaluation starts again */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Logic|Async", meta = (ClampMin = "0.0", Units = "Seconds"))
+	float ResultLifetime = 0.5f;
+
+private:
+	struct FAsyncState
+	{
+		double FinishTime = -1.0;
+		bool bRunning = false;
+		bool bResult = false;
+	};
+
+	double GetTimeSeconds() const;
+	/** Drops finished, expired states and ones of destroyed contexts */
+	void PruneStates(double Now) const;
+
+	mutable TMap<TObjectKey<UObject>, FAsyncState> States;
+};
+
+/** Async condition implemented in Blueprints, K2_FinishCondition has to be called after K2_StartCondition */
+UCLASS(Blueprintable, Abstract, EditInlineNew)
+class EXTRALOGIC_API UBlueprintAsyncCondition : public UAsyncBaseCondition
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintImplementableEvent, Category = "Logic", meta = (DisplayName = "StartCondition"))
+	void K2_StartCondition(UObject* Context) const;
+	UFUNCTION(BlueprintCallable, Category = "Logic", meta = (DisplayName = "FinishCondition"))
+	void K2_FinishCondition(UObject* Context, bool bResult) const;
+
+protected:
+	virtual void StartCondition(UObject* Context) const override;
+};
@@ -17,6 +17,38 @@ enum class EConditionMatchType : uint8
 	ANY
 };
 
+/**
+ *	Tells users of a condition whether its result may be cached.
+ *	@see UBaseCondition::GetCacheLifetime
+ */
+UENUM(BlueprintType)
+enum class EConditionVolatility : uint8
+{
+	/** Depends only on the context and owner, result stays valid until InvalidateCondition() is called */
+	Pure,
+	/** Result stays valid for CacheLifetime seconds or until InvalidateCondition() is called */
+	Timed,
+	/** Evaluated on every check */
+	Volatile
+};
+
+/**
+ *	Result of a condition that may be evaluated over multiple frames.
+ *	@see UBaseCondition::PollCondition
+ */
+UENUM(BlueprintType)
+enum class EConditionResult : uint8
+{
+	False,
+	True,
+	/** Evaluation is in progress, poll again later */
+	Pending
+};
+
+class UBaseCondition;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnConditionInvalidated, const UBaseCondition* /*Condition*/);
+
 /**
  *	This is the base class for condition objects. Derived classes should override
  *	the Condition() function. I also suggest using conditions as Instanced objects
@@ -30,25 +62,53 @@ class EXTRALOGIC_API UBaseCondition : public UObject
 public:
 	/** Call this function externally for condition check. The result is based on bInversed property */
 	bool CheckCondition(UObject* Context) const;
+	/** Non-blocking check, async conditions return Pending until their result is ready. Inversion applies to finished results only */
+	EConditionResult PollCondition(UObject* Context) const;
+	/** Whether the condition may return Pending from PollCondition() */
+	virtual bool IsAsync() const { return false; }
 	/** Overriden to allow latent functions */
 	virtual class UWorld* GetWorld() const override;
 	/** */
 	FString GetConditionName() const { return ConditionName; }
 	/** */
+	bool IsInversed() const { return bInversed; }
+	/** */
 	void SetOwner(AActor* NewOwner) { Owner = NewOwner; }
 	/** */
 	AActor* GetOwner() const { return Owner.Get(); }
+	/** For how long in seconds a result can be reused, 0 if it can't be cached at all */
+	double GetCacheLifetime() const;
+	/** Relative evaluation cost, compiled conditions are checked cheapest first */
+	virtual int32 GetCostHint() const { return CostHint; }
+	/** Notifies users caching results of this condition that they are outdated, call it when inputs of Pure/Timed conditions change */
+	UFUNCTION(BlueprintCallable, Category = "Logic")
+	void InvalidateCondition() const { OnInvalidated.Broadcast(this); }
+	/** */
+	FOnConditionInvalidated& GetOnInvalidated() const { return OnInvalidated; }
 
 protected: 
 	/** The main body of the condition steering logic. A context object can be passed as param if needed. */
 	virtual bool Condition(UObject* Context) const PURE_VIRTUAL(UBaseCondition::CheckCondition, return false;);
+	/** Non-blocking variant of Condition(), synchronous by default */
+	virtual EConditionResult AsyncCondition(UObject* Context) const { return Condition(Context) ? EConditionResult::True : EConditionResult::False; }
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Logic")
 	FString ConditionName = "Base Condition";
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Logic")
 	uint8 bInversed : 1;
+	/** Relative evaluation cost, e.g. 1 for simple comparisons, 10+ for traces or Blueprint heavy logic */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Logic", meta = (ClampMin = "0"))
+	int32 CostHint = 1;
+	/** Whether users may cache the result. Keep Volatile if it depends on something that changes without InvalidateCondition() */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Logic|Cache")
+	EConditionVolatility Volatility = EConditionVolatility::Volatile;
+	/** Lifetime of a cached result of Timed condition */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Logic|Cache", meta = (ClampMin = "0.0", Units = "Seconds", EditCondition = "Volatility == EConditionVolatility::Timed"))
+	float CacheLifetime = 0.25f;
 	
 	TWeakObjectPtr<AActor> Owner;
+
+	mutable FOnConditionInvalidated OnInvalidated;
 };
 
 UCLASS(Blueprintable, Abstract, EditInlineNew)
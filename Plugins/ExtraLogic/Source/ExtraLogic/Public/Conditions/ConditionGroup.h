@@ -0,0 +1,37 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Conditions/BaseCondition.h"
+#include "ConditionGroup.generated.h"
+
+/**
+ *	Combines nested conditions with its own match type, allowing rules like "A and (B or C)".
+ *	Groups are flattened by FConditionProgram, so nesting doesn't add evaluation overhead.
+ *	@see FConditionProgram
+ */
+UCLASS(EditInlineNew, meta = (DisplayName = "Condition Group"))
+class EXTRALOGIC_API UConditionGroup : public UBaseCondition
+{
+	GENERATED_BODY()
+
+public:
+	UConditionGroup();
+
+	/** Sum of nested conditions costs */
+	virtual int32 GetCostHint() const override;
+	/** */
+	EConditionMatchType GetMatchType() const { return MatchType; }
+	/** */
+	const TArray<UBaseCondition*>& GetConditions() const { return Conditions; }
+
+protected:
+	/** Used only when the group is checked directly, outside of a compiled program */
+	virtual bool Condition(UObject* Context) const override;
+
+	UPROPERTY(EditAnywhere, Category = "Logic")
+	EConditionMatchType MatchType;
+	UPROPERTY(EditAnywhere, Category = "Logic", Instanced, meta = (TitleProperty = "ConditionName"))
+	TArray<UBaseCondition*> Conditions;
+};
@@ -0,0 +1,75 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Conditions/BaseCondition.h"
+
+/**
+ *	Flattened, short-circuiting form of a condition list.
+ *
+ *	Every instruction checks a single leaf condition and jumps to the next
+ *	instruction or returns, depending on the result. Condition groups are
+ *	inlined (inversed groups just swap their jump targets) and siblings are
+ *	ordered cheapest first by UBaseCondition::GetCostHint.
+ *
+ *	The program doesn't keep conditions alive, its owner has to reference them.
+ *
+ *	@see UConditionGroup
+ *	@see UBTDecorator_CheckConditions
+ */
+struct EXTRALOGIC_API FConditionProgram
+{
+public:
+	/** Rebuilds the program. Empty list results in ALL -> true, ANY -> false */
+	void Compile(TConstArrayView<UBaseCondition*> Conditions, EConditionMatchType MatchType);
+	/** */
+	void Reset();
+	/** Whether Compile() was called since the last Reset() */
+	bool IsCompiled() const { return !Instructions.IsEmpty(); }
+	/** Runs the program, it has to be compiled */
+	bool Evaluate(UObject* Context) const;
+	/**
+	*	Non-blocking run. Both branches of a pending leaf are followed, so async leaves behind it
+	*	get started in the same poll. The result is Pending only if both True and False can still
+	*	be reached, e.g. ANY with a pending leaf and a true one is True.
+	*/
+	EConditionResult Poll(UObject* Context) const;
+	/** Whether any leaf is async, i.e. Poll() may return Pending */
+	bool HasAsyncConditions() const { return bHasAsyncConditions; }
+
+	/** Leaf conditions the program evaluates, groups excluded */
+	TConstArrayView<const UBaseCondition*> GetLeafConditions() const { return Leaves; }
+	/** Shortest cache lifetime of the leaves, see UBaseCondition::GetCacheLifetime */
+	double GetCacheLifetime() const;
+
+private:
+	struct FInstruction
+	{
+		/** nullptr is an unconditional jump to OnTrue */
+		const UBaseCondition* Condition;
+		int16 OnTrue;
+		int16 OnFalse;
+	};
+
+	static constexpr int16 ReturnTrue = -1;
+	static constexpr int16 ReturnFalse = -2;
+
+	/** Labels are resolved to instruction indices once everything is emitted */
+	struct FCompiler
+	{
+		TArray<FInstruction>& Instructions;
+		TArray<const UBaseCondition*>& Leaves;
+		TArray<int32, TInlineAllocator<16>> LabelTargets;
+
+		int32 NewLabel();
+		void BindLabel(int32 Label);
+		void EmitList(TConstArrayView<UBaseCondition*> Conditions, EConditionMatchType MatchType, int32 TrueLabel, int32 FalseLabel, int32 Depth);
+		void EmitCondition(const UBaseCondition* Condition, int32 TrueLabel, int32 FalseLabel, int32 Depth);
+		void Resolve();
+	};
+
+	TArray<FInstruction> Instructions;
+	TArray<const UBaseCondition*> Leaves;
+	bool bHasAsyncConditions = false;
+};
@@ -0,0 +1,153 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Conditions/BaseCondition.h"
+#include "GameplayTagContainer.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "NativeConditions.generated.h"
+
+/**
+ *	Data driven conditions evaluated natively, without going through the Blueprint VM.
+ *	Prefer them over UBlueprintBaseCondition for simple checks, Blueprint conditions
+ *	are meant for truly custom logic.
+ *
+ *	Context is expected to be an actor. Controllers are resolved to their pawns
+ *	where the check is about the physical agent (tags, distance).
+ */
+
+/** Passes when gameplay tags of the context match the query. Context has to implement IGameplayTagAssetInterface, its tags are copied for every check */
+UCLASS(meta = (DisplayName = "Gameplay Tag Query"))
+class EXTRALOGIC_API UCondition_GameplayTagQuery : public UBaseCondition
+{
+	GENERATED_BODY()
+
+public:
+	UCondition_GameplayTagQuery();
+
+protected:
+	virtual bool Condition(UObject* Context) const override;
+
+	UPROPERTY(EditAnywhere, Category = "Condition")
+	FGameplayTagQuery TagQuery;
+};
+
+/** Passes when the context is within [MinDistance, MaxDistance] from the condition owner, or the actor holding the condition if no owner is set */
+UCLASS(meta = (DisplayName = "Distance Band"))
+class EXTRALOGIC_API UCondition_DistanceBand : public UBaseCondition
+{
+	GENERATED_BODY()
+
+public:
+	UCondition_DistanceBand();
+
+protected:
+	virtual bool Condition(UObject* Context) const override;
+
+	UPROPERTY(EditAnywhere, Category = "Condition", meta = (ClampMin = "0.0", Units = "Centimeters"))
+	float MinDistance = 0.f;
+	UPROPERTY(EditAnywhere, Category = "Condition", meta = (ClampMin = "0.0", Units = "Centimeters"))
+	float MaxDistance = 1000.f;
+	/** Ignores height difference */
+	UPROPERTY(EditAnywhere, Category = "Condition")
+	bool bIgnoreZ = false;
+};
+
+UENUM(BlueprintType)
+enum class EBlackboardCompareOp : uint8
+{
+	IsSet,
+	IsNotSet,
+	Equal,
+	NotEqual,
+	Less,
+	LessOrEqual,
+	Greater,
+	GreaterOrEqual
+};
+
+/** Compares a blackboard key of the context's AI controller. Set checks work for any key, the rest only for numeric ones (bool, int, float, enum) */
+UCLASS(meta = (DisplayName = "Blackboard Compare"))
+class EXTRALOGIC_API UCondition_BlackboardCompare : public UBaseCondition
+{
+	GENERATED_BODY()
+
+public:
+	UCondition_BlackboardCompare();
+
+protected:
+	virtual bool Condition(UObject* Context) const override;
+
+	UPROPERTY(EditAnywhere, Category = "Condition")
+	FName KeyName;
+	UPROPERTY(EditAnywhere, Category = "Condition")
+	EBlackboardCompareOp Operation = EBlackboardCompareOp::IsSet;
+	/** Int based keys compare against the rounded value */
+	UPROPERTY(EditAnywhere, Category = "Condition", meta = (EditCondition = "Operation != EBlackboardCompareOp::IsSet && Operation != EBlackboardCompareOp::IsNotSet"))
+	float Value = 0.f;
+
+private:
+	/** Cached key of KeyName in the asset, resolved once per asset */
+	FBlackboard::FKey GetKeyID(const UBlackboardData& BlackboardAsset) const;
+
+	struct FKeyBinding
+	{
+		TWeakObjectPtr<const UBlackboardData> Asset;
+		FBlackboard::FKey Key;
+	};
+
+	/** Condition is shared by every agent using it, they rarely have more than one blackboard asset */
+	mutable TArray<FKeyBinding, TInlineAllocator<1>> KeyBindings;
+};
+
+UENUM(BlueprintType)
+enum class ETimeOfDaySource : uint8
+{
+	/** World time wrapped by DayLength */
+	WorldTime,
+	/** Local time of the machine */
+	SystemClock
+};
+
+/** Passes within [StartHour, EndHour) window, windows crossing midnight (e.g. 22 - 6) are supported */
+UCLASS(meta = (DisplayName = "Time Of Day Window"))
+class EXTRALOGIC_API UCondition_TimeOfDay : public UBaseCondition
+{
+	GENERATED_BODY()
+
+public:
+	UCondition_TimeOfDay();
+
+protected:
+	virtual bool Condition(UObject* Context) const override;
+
+	UPROPERTY(EditAnywhere, Category = "Condition")
+	ETimeOfDaySource Source = ETimeOfDaySource::WorldTime;
+	/** Length of a full in-game day */
+	UPROPERTY(EditAnywhere, Category = "Condition", meta = (ClampMin = "1.0", Units = "Seconds", EditCondition = "Source == ETimeOfDaySource::WorldTime"))
+	float DayLength = 1440.f;
+	UPROPERTY(EditAnywhere, Category = "Condition", meta = (ClampMin = "0.0", ClampMax = "24.0"))
+	float StartHour = 8.f;
+	UPROPERTY(EditAnywhere, Category = "Condition", meta = (ClampMin = "0.0", ClampMax = "24.0"))
+	float EndHour = 20.f;
+};
+
+/** Passes when the context, or its pawn if it's a controller, is of the given class. Pure, so call InvalidateCondition() if cached users repossess pawns */
+UCLASS(meta = (DisplayName = "Actor Class"))
+class EXTRALOGIC_API UCondition_ActorClass : public UBaseCondition
+{
+	GENERATED_BODY()
+
+public:
+	UCondition_ActorClass();
+
+protected:
+	virtual bool Condition(UObject* Context) const override;
+
+	UPROPERTY(EditAnywhere, Category = "Condition")
+	TSubclassOf<AActor> ActorClass;
+	/** Subclasses don't pass */
+	UPROPERTY(EditAnywhere, Category = "Condition")
+	bool bExactMatch = false;
+};
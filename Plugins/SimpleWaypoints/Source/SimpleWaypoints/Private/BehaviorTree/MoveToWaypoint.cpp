@@ -3,30 +3,129 @@
 
 #include "BehaviorTree/MoveToWaypoint.h"
 #include "AIController.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "NavMesh/NavMeshPath.h"
+#include "NavigationData.h"
 #include "Objects/WaypointFollower.h"
 #include "Objects/Waypoint.h"
+#include "Subsystems/WaypointPathCacheSubsystem.h"
 
 UMoveToWaypoint::UMoveToWaypoint()
 {
 	NodeName = "Move To Waypoint";
+	bUsePathCache = true;
+	// Moves may finish latently, waypoint is reached or ignored once they do
+	bNotifyTaskFinished = true;
 }
 
 EBTNodeResult::Type UMoveToWaypoint::PerformMoveTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
 {
-	EBTNodeResult::Type Result = Super::PerformMoveTask(OwnerComp, NodeMemory);
-	if (UWaypointFollower* WPFollower = UWaypointFollower::GetWaypointFollower(OwnerComp.GetOwner()))
+	AWaypoint* WP = Cast<AWaypoint>(OwnerComp.GetBlackboardComponent()->GetValueAsObject(BlackboardKey.SelectedKeyName));
+
+	EBTNodeResult::Type Result = EBTNodeResult::Failed;
+	if (!WP || !PerformCachedMove(OwnerComp, NodeMemory, *WP, Result))
+	{
+		Result = Super::PerformMoveTask(OwnerComp, NodeMemory);
+	}
+	return Result;
+}
+
+void UMoveToWaypoint::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult)
+{
+	Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
+
+	// Observed key may have changed during the move, the one in the blackboard now is the one that was moved to
+	const UBlackboardComponent* BBComp = OwnerComp.GetBlackboardComponent();
+	AWaypoint* WP = BBComp ? Cast<AWaypoint>(BBComp->GetValueAsObject(BlackboardKey.SelectedKeyName)) : nullptr;
+	UWaypointFollower* WPFollower = OwnerComp.GetOwner() ? UWaypointFollower::GetWaypointFollower(OwnerComp.GetOwner()) : nullptr;
+	if (WP && WPFollower)
 	{
-		if (AWaypoint* WP = Cast<AWaypoint>(OwnerComp.GetBlackboardComponent()->GetValueAsObject(BlackboardKey.SelectedKeyName)))
+		if (TaskResult == EBTNodeResult::Failed)
+		{
+			WPFollower->IgnoreWaypoint(WP);
+		}
+		else if (TaskResult == EBTNodeResult::Succeeded)
 		{
-			if (Result == EBTNodeResult::Failed)
-			{
-				WPFollower->IgnoreWaypoint(WP);
-			}
-			else if (Result == EBTNodeResult::Succeeded)
-			{
-				WPFollower->ReachWaypoint();
-			}
+			WPFollower->ReachWaypoint();
 		}
 	}
-	return Result;
+}
+
+bool UMoveToWaypoint::PerformCachedMove(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, AWaypoint& Destination, EBTNodeResult::Type& OutResult)
+{
+	AAIController* MyController = OwnerComp.GetAIOwner();
+	const UWaypointFollower* WPFollower = UWaypointFollower::GetWaypointFollower(OwnerComp.GetOwner());
+	const AWaypoint* Source = WPFollower ? WPFollower->GetLastReachedWaypoint() : nullptr;
+	// Released node waypoints stay referenced until garbage collection
+	if (!bUsePathCache || !MyController || !MyController->GetPathFollowingComponent() || !IsValid(Source) || Source == &Destination)
+	{
+		return false;
+	}
+
+	// Shared path starts at the waypoint, pawns that wandered off it need their own one
+	if (FVector::DistSquared(MyController->GetNavAgentLocation(), Source->GetActorLocation()) > FMath::Square(MaxCachedPathStartOffset))
+	{
+		return false;
+	}
+
+	// Regular MoveTo succeeds right away if the pawn is already there, requesting a path move would never finish
+	const float AcceptanceRadius = AcceptableRadius.GetValue(OwnerComp);
+	if (MyController->GetPathFollowingComponent()->HasReached(Destination.GetActorLocation(), EPathFollowingReachMode::OverlapAgent, AcceptanceRadius))
+	{
+		return false;
+	}
+
+	UWaypointPathCacheSubsystem* PathCache = UWorld::GetSubsystem<UWaypointPathCacheSubsystem>(OwnerComp.GetWorld());
+	// Paths are cached per filter class, resolve the default one so controllers with different defaults don't share paths
+	TSubclassOf<UNavigationQueryFilter> Filter = FilterClass.GetValue(OwnerComp);
+	if (!*Filter)
+	{
+		Filter = MyController->GetDefaultNavigationFilterClass();
+	}
+	FNavPathSharedPtr Path = PathCache ? PathCache->FindPath(*MyController, *Source, Destination, Filter) : nullptr;
+	if (!Path.IsValid())
+	{
+		return false;
+	}
+
+	// Path following modifies the path it follows (reached points, repaths), every agent gets a copy of the points
+	FNavPathSharedPtr MovePath;
+	if (const FNavMeshPath* NavMeshPath = Path->CastPath<FNavMeshPath>())
+	{
+		MovePath = MakeShared<FNavMeshPath>(*NavMeshPath);
+	}
+	else
+	{
+		MovePath = MakeShared<FNavigationPath>(*Path);
+	}
+	MovePath->SetQuerier(MyController);
+	if (ANavigationData* NavData = MovePath->GetNavigationDataUsed())
+	{
+		NavData->RegisterActivePath(MovePath);
+	}
+
+	FAIMoveRequest MoveReq(Destination.GetActorLocation());
+	MoveReq.SetNavigationFilter(Filter);
+	MoveReq.SetAcceptanceRadius(AcceptanceRadius);
+	MoveReq.SetReachTestIncludesAgentRadius(bReachTestIncludesAgentRadius.GetValue(OwnerComp));
+	MoveReq.SetReachTestIncludesGoalRadius(bReachTestIncludesGoalRadius.GetValue(OwnerComp));
+	MoveReq.SetCanStrafe(bAllowStrafe.GetValue(OwnerComp));
+	MoveReq.SetAllowPartialPath(bAllowPartialPath.GetValue(OwnerComp));
+	MoveReq.SetUsePathfinding(true);
+
+	// Same flow as MoveTo without gameplay tasks: path following reports back through AI messages
+	const FAIRequestID RequestID = MyController->RequestMove(MoveReq, MovePath);
+	if (!RequestID.IsValid())
+	{
+		return false;
+	}
+
+	FBTMoveToTaskMemory* MyMemory = CastInstanceNodeMemory<FBTMoveToTaskMemory>(NodeMemory);
+	MyMemory->MoveRequestID = RequestID;
+	WaitForMessage(OwnerComp, UBrainComponent::AIMessage_MoveFinished, RequestID);
+	WaitForMessage(OwnerComp, UBrainComponent::AIMessage_RepathFailed);
+
+	OutResult = EBTNodeResult::InProgress;
+	return true;
 }
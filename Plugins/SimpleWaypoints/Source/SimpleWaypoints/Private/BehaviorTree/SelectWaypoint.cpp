@@ -6,6 +6,7 @@
 #include "AIController.h"
 #include "Objects/WaypointFollower.h"
 #include "Objects/Waypoint.h"
+#include "Subsystems/WaypointSelectionSubsystem.h"
 
 USelectWaypoint::USelectWaypoint(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -13,7 +14,7 @@ USelectWaypoint::USelectWaypoint(const FObjectInitializer& ObjectInitializer)
 	NodeName = "Select Waypoint";
 	bNotifyOnSearch = false;
 	bNotifyTick = false;
-	bNotifyCeaseRelevant = false;
+	bNotifyCeaseRelevant = true;
 	bNotifyBecomeRelevant = true;
 
 	Waypoint.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(USelectWaypoint, Waypoint), AActor::StaticClass());
@@ -40,15 +41,41 @@ void USelectWaypoint::OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8*
 		{
 			if (UBlackboardComponent* BBComp = OwnerComp.GetBlackboardComponent())
 			{
-				BBComp->SetValueAsObject(Waypoint.SelectedKeyName, WPFollower->SelectWaypoint());
+				UWaypointSelectionSubsystem* SelectionSubsystem = bDeferSelection ? UWorld::GetSubsystem<UWaypointSelectionSubsystem>(OwnerComp.GetWorld()) : nullptr;
+				if (SelectionSubsystem)
+				{
+					const FName KeyName = Waypoint.SelectedKeyName;
+					BBComp->ClearValue(KeyName);
+					SelectionSubsystem->RequestSelection(WPFollower, FOnWaypointSelected::CreateWeakLambda(BBComp, [BBComp, KeyName](AWaypoint* SelectedWaypoint)
+						{
+							BBComp->SetValueAsObject(KeyName, SelectedWaypoint);
+						}));
+				}
+				else
+				{
+					BBComp->SetValueAsObject(Waypoint.SelectedKeyName, WPFollower->SelectWaypoint());
+				}
 			}
 		}
 	}
 }
 
+void USelectWaypoint::OnCeaseRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	Super::OnCeaseRelevant(OwnerComp, NodeMemory);
+
+	if (bDeferSelection && OwnerComp.GetOwner())
+	{
+		if (UWaypointSelectionSubsystem* SelectionSubsystem = UWorld::GetSubsystem<UWaypointSelectionSubsystem>(OwnerComp.GetWorld()))
+		{
+			SelectionSubsystem->CancelSelection(UWaypointFollower::GetWaypointFollower(OwnerComp.GetOwner()));
+		}
+	}
+}
+
 FString USelectWaypoint::GetStaticDescription() const
 {
-	return "Selects Waypoint on activation";
+	return bDeferSelection ? "Queues Waypoint selection on activation" : "Selects Waypoint on activation";
 }
 
 #if WITH_EDITOR
@@ -2,14 +2,55 @@
 
 
 #include "Objects/Waypoint.h"
+#include "Objects/WaypointGraph.h"
+#include "Objects/WaypointNode.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Components/TextRenderComponent.h"
 #include "Components/ArrowComponent.h"
+#include "Containers/Ticker.h"
+#include "UObject/ObjectSaveContext.h"
+#include "SimpleWaypointsStats.h"
+#include "BBValueProvider/BBValueProvider_Base.h"
 
 
+FWaypointReservation::FWaypointReservation(FWaypointReservation&& Other)
+	: Occupancy(MoveTemp(Other.Occupancy))
+	, Waypoint(Other.Waypoint)
+{
+	Other.Occupancy.Reset();
+}
+
+FWaypointReservation& FWaypointReservation::operator=(FWaypointReservation&& Other)
+{
+	if (this != &Other)
+	{
+		Release();
+		Occupancy = MoveTemp(Other.Occupancy);
+		Waypoint = Other.Waypoint;
+		Other.Occupancy.Reset();
+	}
+	return *this;
+}
+
+void FWaypointReservation::Release()
+{
+	if (Occupancy.IsValid())
+	{
+		Occupancy->CurrentUsers.fetch_sub(1, std::memory_order_relaxed);
+		Occupancy.Reset();
+
+		if (AWaypoint* ReservedWaypoint = Waypoint.Get())
+		{
+			ReservedWaypoint->OnOccupancyChanged();
+		}
+	}
+}
+
 AWaypoint::AWaypoint(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {	
+	Occupancy = MakeShared<FWaypointOccupancy, ESPMode::ThreadSafe>();
+
 	Mesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Mesh"));
 	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	Mesh->SetGenerateOverlapEvents(false);
@@ -42,86 +83,295 @@ AWaypoint::AWaypoint(const FObjectInitializer& ObjectInitializer)
 #endif
 }
 
-void AWaypoint::OccupyWaypoint()
+FWaypointReservation AWaypoint::TryReserve()
+{
+	if (!Occupancy.IsValid())
+	{
+		return FWaypointReservation();
+	}
+
+	int32 CurrentUsers = Occupancy->CurrentUsers.load(std::memory_order_relaxed);
+	do
+	{
+		if (CurrentUsers >= MaxUsers)
+		{
+			return FWaypointReservation();
+		}
+	}
+	while (!Occupancy->CurrentUsers.compare_exchange_weak(CurrentUsers, CurrentUsers + 1, std::memory_order_relaxed));
+
+	FWaypointReservation Reservation;
+	Reservation.Occupancy = Occupancy;
+	Reservation.Waypoint = this;
+	OnOccupancyChanged();
+	return Reservation;
+}
+
+FWaypointReservation AWaypoint::Reserve()
+{
+	if (!Occupancy.IsValid())
+	{
+		return FWaypointReservation();
+	}
+
+	Occupancy->CurrentUsers.fetch_add(1, std::memory_order_relaxed);
+
+	FWaypointReservation Reservation;
+	Reservation.Occupancy = Occupancy;
+	Reservation.Waypoint = this;
+	OnOccupancyChanged();
+	return Reservation;
+}
+
+void AWaypoint::OnOccupancyChanged()
 {
-	CurrentUsers++;
 #if WITH_EDITOR
-	UpdateDebugText();
+	// Reservations can be made during parallel selection, debug text is updated on the next core tick on game thread
+	if (!bDebugTextQueued.exchange(true))
+	{
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+		{
+			bDebugTextQueued = false;
+			UpdateDebugText();
+			return false;
+		}));
+	}
 #endif
 }
 
-void AWaypoint::ReleaseWaypoint()
+void AWaypoint::SetDestination(AWaypoint* Destination, uint8 Weight)
+{
+	if (Destination)
+	{
+		Destinations.Add(Destination, Weight);
+	}
+}
+
+void AWaypoint::AddCondition(UBaseCondition* Condition)
 {
-	CurrentUsers--;
+	if (Condition)
+	{
+		UseConditions.Add(Condition);
+		if (ConditionProgram.IsCompiled())
+		{
+			CompileConditions();
+		}
+	}
+}
+
+void AWaypoint::SetPointEnabled(bool bNewEnabled)
+{
+	if (bIsEnabled != bNewEnabled)
+	{
+		bIsEnabled = bNewEnabled;
+		if (AWaypointGraph* Graph = GetOwningGraph())
+		{
+			Graph->UpdateWaypointRouting(this);
+		}
+	}
 #if WITH_EDITOR
 	UpdateDebugText();
 #endif
 }
 
-void AWaypoint::SetPointEnabled(bool bNewEnabled)
+void AWaypoint::SetRouteCostScale(float NewScale)
+{
+	NewScale = FMath::Max(NewScale, 1.f);
+	if (RouteCostScale != NewScale)
+	{
+		RouteCostScale = NewScale;
+		if (AWaypointGraph* Graph = GetOwningGraph())
+		{
+			Graph->UpdateWaypointRouting(this);
+		}
+	}
+}
+
+void AWaypoint::SetMeshVisible(bool bVisible)
 {
-	bIsEnabled = bNewEnabled;
+	if (Mesh)
+	{
+		Mesh->SetVisibility(bVisible);
+	}
 #if WITH_EDITOR
-	UpdateDebugText();
+	bMeshHiddenByVisualizer = !bVisible;
 #endif
 }
 
-bool AWaypoint::CheckConditions(AActor* User)
+AWaypointGraph* AWaypoint::GetOwningGraph() const
 {
-	if (UseConditions.IsEmpty())
+	// Waypoints spawned from nodes aren't attached, so the graph doesn't count them as its children
+	if (AWaypointGraph* Graph = Cast<AWaypointGraph>(GetAttachParentActor()))
 	{
-		return true;
+		return Graph;
 	}
+	return Cast<AWaypointGraph>(GetOwner());
+}
 
-	for (int i = UseConditions.Num() - 1; i >= 0; --i)
+void AWaypoint::InitFromNode(const FWaypointNode& Node)
+{
+	Cooldown = Node.Cooldown;
+	bIsEnabled = Node.bIsEnabled;
+	MaxUsers = Node.MaxUsers;
+	RouteCostScale = Node.RouteCostScale;
+	bPerformBehavior = Node.bPerformBehavior;
+	Behavior = Node.Behavior;
+	BehaviorValues = Node.BehaviorValues;
+	MatchType = Node.MatchType;
+
+	UseConditions.Reset(Node.UseConditions.Num());
+	for (const UBaseCondition* Condition : Node.UseConditions)
 	{
-		if (UseConditions[i]->CheckCondition(User))
+		if (Condition)
 		{
-			if (MatchType == EConditionMatchType::ANY)
-			{
-				return true;
-			}
+			UseConditions.Add(DuplicateObject(Condition, this));
 		}
-		else
+	}
+	ConditionProgram.Reset();
+}
+
+void AWaypoint::ToNode(FWaypointNode& OutNode, UObject* ConditionsOuter) const
+{
+	OutNode.Cooldown = Cooldown;
+	OutNode.bIsEnabled = bIsEnabled;
+	OutNode.MaxUsers = MaxUsers;
+	OutNode.RouteCostScale = RouteCostScale;
+	OutNode.bPerformBehavior = bPerformBehavior;
+	OutNode.Behavior = Behavior;
+	OutNode.BehaviorValues = BehaviorValues;
+	OutNode.MatchType = MatchType;
+
+	OutNode.UseConditions.Reset(UseConditions.Num());
+	for (const UBaseCondition* Condition : UseConditions)
+	{
+		if (Condition)
+		{
+			OutNode.UseConditions.Add(DuplicateObject(Condition, ConditionsOuter));
+		}
+	}
+}
+
+EConditionResult AWaypoint::PollConditions(AActor* User)
+{
+	if (UseConditions.IsEmpty())
+	{
+		return EConditionResult::True;
+	}
+
+	if (!ConditionProgram.IsCompiled())
+	{
+		CompileConditions();
+	}
+
+	if (ConditionCacheLifetime <= 0.0)
+	{
+		return EvaluateConditions(User);
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (const FConditionCacheEntry* Entry = ConditionCache.Find(User); Entry && Entry->ExpiryTime > Now)
+	{
+		INC_DWORD_STAT(STAT_WaypointConditionCacheHits);
+		return Entry->bResult ? EConditionResult::True : EConditionResult::False;
+	}
+
+	const EConditionResult Result = EvaluateConditions(User);
+	if (Result != EConditionResult::Pending)
+	{
+		if (ConditionCache.Num() >= NextConditionCachePrune)
 		{
-			if (MatchType == EConditionMatchType::ALL)
-			{
-				return false;
-			}
+			PruneConditionCache(Now);
 		}
+		ConditionCache.Add(User, { Now + ConditionCacheLifetime, Result == EConditionResult::True });
+	}
+	return Result;
+}
+
+void AWaypoint::InvalidateConditionCache(const AActor* User)
+{
+	if (User)
+	{
+		ConditionCache.Remove(User);
+	}
+	else
+	{
+		ConditionCache.Reset();
 	}
+}
+
+EConditionResult AWaypoint::EvaluateConditions(AActor* User) const
+{
+	SIMPLEWAYPOINTS_SCOPE(CheckConditions);
+
+	return ConditionProgram.Poll(User);
+}
+
+void AWaypoint::CompileConditions()
+{
+	UnbindConditions();
+
+	ConditionProgram.Compile(UseConditions, MatchType);
+	// Any Volatile condition disables caching, otherwise the shortest lifetime wins
+	ConditionCacheLifetime = ConditionProgram.GetCacheLifetime();
+	for (const UBaseCondition* Condition : ConditionProgram.GetLeafConditions())
+	{
+		Condition->GetOnInvalidated().AddUObject(this, &AWaypoint::OnConditionInvalidated);
+	}
+	ConditionCache.Reset();
+}
 
-	return MatchType == EConditionMatchType::ALL;
+void AWaypoint::UnbindConditions()
+{
+	for (const UBaseCondition* Condition : ConditionProgram.GetLeafConditions())
+	{
+		Condition->GetOnInvalidated().RemoveAll(this);
+	}
+}
+
+void AWaypoint::OnConditionInvalidated(const UBaseCondition* Condition)
+{
+	ConditionCache.Reset();
+}
+
+void AWaypoint::PruneConditionCache(double Now)
+{
+	for (auto It = ConditionCache.CreateIterator(); It; ++It)
+	{
+		if (It->Value.ExpiryTime <= Now || !It->Key.ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+	NextConditionCachePrune = FMath::Max(32, ConditionCache.Num() * 2);
 }
 
 void AWaypoint::PostLoad()
 {
 	Super::PostLoad();
+
+	UBBValueProvider_Base::MigrateToValues(BehaviorParams_DEPRECATED, BehaviorValues);
 #if WITH_EDITOR
 	UpdateDebugText();
 #endif
 }
 
-#if WITH_EDITOR
-void AWaypoint::DrawDestinationsArrows()
+void AWaypoint::BeginPlay()
 {
-	for (const auto& Destination : Destinations)
-	{
-		if (Destination.Key)
-		{
-			DrawDebugDirectionalArrow(GetWorld(),
-			GetActorLocation(),
-			Destination.Key->GetActorLocation(),
-			50.f,
-			Destination.Key->HasConditions() ? FColor::Blue : (Destination.Key->IsPointEnabled() ? FColor::Green : FColor::Red),
-			false,
-			0.f,
-			SDPG_Foreground,
-			Destination.Value + 1.f);
-		}
-	}
+	Super::BeginPlay();
+
+	CompileConditions();
 }
 
+void AWaypoint::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnbindConditions();
+	ConditionProgram.Reset();
+	ConditionCache.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+#if WITH_EDITOR
 void AWaypoint::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	Super::PostEditChangeProperty(PropertyChangedEvent);
@@ -135,6 +385,58 @@ void AWaypoint::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEve
 	{
 		UpdateDebugText();
 	}
+	else if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(AWaypoint, UseConditions) ||
+		PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(AWaypoint, MatchType))
+	{
+		// Recompiled on the next check
+		UnbindConditions();
+		ConditionProgram.Reset();
+	}
+
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(AWaypoint, Destinations) ||
+		PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(AWaypoint, bIsEnabled) ||
+		PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(AWaypoint, UseConditions))
+	{
+		if (AWaypointGraph* Graph = GetOwningGraph())
+		{
+			Graph->MarkVisualizationDirty();
+		}
+	}
+}
+
+void AWaypoint::PostEditMove(bool bFinished)
+{
+	Super::PostEditMove(bFinished);
+
+	if (AWaypointGraph* Graph = GetOwningGraph())
+	{
+		Graph->MarkVisualizationDirty();
+	}
+}
+
+void AWaypoint::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	if (AWaypointGraph* Graph = GetOwningGraph())
+	{
+		Graph->MarkVisualizationDirty();
+	}
+}
+
+void AWaypoint::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+
+	// Visualizer hides it again on its next rebuild
+	if (bMeshHiddenByVisualizer)
+	{
+		SetMeshVisible(true);
+		if (AWaypointGraph* Graph = GetOwningGraph())
+		{
+			Graph->MarkVisualizationDirty();
+		}
+	}
 }
 
 void AWaypoint::UpdateDebugText()
@@ -152,7 +454,7 @@ void AWaypoint::UpdateDebugText()
 			OutputText = "Disabled\n";
 			Text->SetTextRenderColor(FColor::Red);
 		}
-		OutputText += FString::Printf(TEXT("Users: %u / %u"), CurrentUsers, MaxUsers);
+		OutputText += FString::Printf(TEXT("Users: %d / %u"), GetCurrentUsers(), MaxUsers);
 		Text->SetText(FText::FromString(OutputText));
 	}
 }
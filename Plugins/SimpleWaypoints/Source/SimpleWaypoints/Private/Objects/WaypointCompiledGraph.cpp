@@ -0,0 +1,224 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+
+#include "Objects/WaypointCompiledGraph.h"
+#include "Objects/Waypoint.h"
+#include "Objects/WaypointNode.h"
+#include "Hash/xxhash.h"
+#include "Serialization/CustomVersion.h"
+
+const FGuid FWaypointGraphCustomVersion::GUID(0x6C1E2F4A, 0x93B84D07, 0xA5E1C2D8, 0x3F7B9046);
+static FCustomVersionRegistration GRegisterWaypointGraphCustomVersion(FWaypointGraphCustomVersion::GUID, FWaypointGraphCustomVersion::LatestVersion, TEXT("WaypointGraphVer"));
+
+
+void FWaypointCompiledGraph::Compile(TConstArrayView<AWaypoint*> Waypoints, TConstArrayView<FWaypointNode> Nodes)
+{
+	Reset();
+	++Version;
+	SourceHash = ComputeSourceHash(Waypoints, Nodes);
+
+	// Waypoints store their own index, make sure it is up to date before resolving edges
+	AssignGraphIndices(Waypoints);
+
+	Offsets.Reserve(Waypoints.Num() + Nodes.Num() + 1);
+	for (const AWaypoint* Waypoint : Waypoints)
+	{
+		Offsets.Add(Destinations.Num());
+		if (!Waypoint)
+		{
+			continue;
+		}
+
+		for (const auto& Destination : Waypoint->ViewDestinations())
+		{
+			const int32 DestinationIndex = Destination.Key ? Destination.Key->GetGraphIndex() : INDEX_NONE;
+			if (Waypoints.IsValidIndex(DestinationIndex) && Waypoints[DestinationIndex] == Destination.Key)
+			{
+				Destinations.Add(DestinationIndex);
+				Weights.Add(Destination.Value);
+			}
+		}
+	}
+	// Data only waypoints follow the actors
+	for (const FWaypointNode& Node : Nodes)
+	{
+		Offsets.Add(Destinations.Num());
+		for (const FWaypointNodeDestination& Destination : Node.Destinations)
+		{
+			if (Nodes.IsValidIndex(Destination.Node))
+			{
+				Destinations.Add(Waypoints.Num() + Destination.Node);
+				Weights.Add(Destination.Weight);
+			}
+		}
+	}
+	Offsets.Add(Destinations.Num());
+
+	AliasProbabilities.SetNumUninitialized(Destinations.Num());
+	AliasSlots.SetNumUninitialized(Destinations.Num());
+	for (int32 Node = 0; Node < NumNodes(); ++Node)
+	{
+		BuildAliasTable(Node);
+	}
+}
+
+void FWaypointCompiledGraph::Reset()
+{
+	Offsets.Reset();
+	Destinations.Reset();
+	Weights.Reset();
+	AliasProbabilities.Reset();
+	AliasSlots.Reset();
+	SourceHash = 0;
+}
+
+bool FWaypointCompiledGraph::IsCompiledFrom(TConstArrayView<AWaypoint*> Waypoints, TConstArrayView<FWaypointNode> Nodes, bool bCheckHash) const
+{
+	return NumNodes() == Waypoints.Num() + Nodes.Num() && (!bCheckHash || SourceHash == ComputeSourceHash(Waypoints, Nodes));
+}
+
+void FWaypointCompiledGraph::AssignGraphIndices(TConstArrayView<AWaypoint*> Waypoints)
+{
+	for (int32 i = 0; i < Waypoints.Num(); ++i)
+	{
+		if (Waypoints[i])
+		{
+			Waypoints[i]->SetGraphIndex(i);
+		}
+	}
+}
+
+uint64 FWaypointCompiledGraph::ComputeSourceHash(TConstArrayView<AWaypoint*> Waypoints, TConstArrayView<FWaypointNode> Nodes)
+{
+	// Same resolution as in Compile(): duplicates take the last index, unknown destinations are skipped
+	TMap<const AWaypoint*, int32> Indices;
+	Indices.Reserve(Waypoints.Num());
+	for (int32 i = 0; i < Waypoints.Num(); ++i)
+	{
+		if (Waypoints[i])
+		{
+			Indices.Add(Waypoints[i], i);
+		}
+	}
+
+	FXxHash64Builder Builder;
+	const uint32 Header[] = { FormatVersion, uint32(Waypoints.Num()), uint32(Nodes.Num()) };
+	Builder.Update(Header, sizeof(Header));
+	for (const AWaypoint* Waypoint : Waypoints)
+	{
+		int32 NumResolved = 0;
+		if (Waypoint)
+		{
+			for (const auto& Destination : Waypoint->ViewDestinations())
+			{
+				if (const int32* DestinationIndex = Indices.Find(Destination.Key))
+				{
+					const int32 Edge[] = { *DestinationIndex, int32(Destination.Value) };
+					Builder.Update(Edge, sizeof(Edge));
+					++NumResolved;
+				}
+			}
+		}
+
+		// Terminates the node's edges, null waypoints hash differently from ones without destinations
+		const int32 Terminator = Waypoint ? NumResolved : INDEX_NONE;
+		Builder.Update(&Terminator, sizeof(Terminator));
+	}
+	for (const FWaypointNode& Node : Nodes)
+	{
+		int32 NumResolved = 0;
+		for (const FWaypointNodeDestination& Destination : Node.Destinations)
+		{
+			if (Nodes.IsValidIndex(Destination.Node))
+			{
+				const int32 Edge[] = { Waypoints.Num() + Destination.Node, int32(Destination.Weight) };
+				Builder.Update(Edge, sizeof(Edge));
+				++NumResolved;
+			}
+		}
+		Builder.Update(&NumResolved, sizeof(NumResolved));
+	}
+	return Builder.Finalize().Hash;
+}
+
+FArchive& operator<<(FArchive& Ar, FWaypointCompiledGraph& Graph)
+{
+	Ar << Graph.SourceHash;
+	Graph.Offsets.BulkSerialize(Ar);
+	Graph.Destinations.BulkSerialize(Ar);
+	Graph.Weights.BulkSerialize(Ar);
+	Graph.AliasProbabilities.BulkSerialize(Ar);
+	Graph.AliasSlots.BulkSerialize(Ar);
+
+	if (Ar.IsLoading())
+	{
+		// Loaded data replaces whatever was compiled before
+		++Graph.Version;
+	}
+	return Ar;
+}
+
+int32 FWaypointCompiledGraph::SampleDestination(int32 Node) const
+{
+	const int32 NumNodeEdges = GetNumEdges(Node);
+	if (NumNodeEdges <= 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 FirstEdge = Offsets[Node];
+	const int32 Slot = FMath::RandRange(0, NumNodeEdges - 1);
+	const int32 Edge = FMath::FRand() < AliasProbabilities[FirstEdge + Slot] ? FirstEdge + Slot : FirstEdge + AliasSlots[FirstEdge + Slot];
+	return Destinations[Edge];
+}
+
+void FWaypointCompiledGraph::BuildAliasTable(int32 Node)
+{
+	const int32 FirstEdge = Offsets[Node];
+	const int32 NumNodeEdges = GetNumEdges(Node);
+	if (NumNodeEdges <= 0)
+	{
+		return;
+	}
+
+	int32 TotalWeight = 0;
+	for (int32 Slot = 0; Slot < NumNodeEdges; ++Slot)
+	{
+		TotalWeight += GetEffectiveWeight(Weights[FirstEdge + Slot]);
+	}
+
+	// Vose's method: scale weights so the average is 1, then pair each underfull slot with an overfull one
+	TArray<double, TInlineAllocator<32>> Scaled;
+	TArray<int32, TInlineAllocator<32>> Small;
+	TArray<int32, TInlineAllocator<32>> Large;
+	Scaled.SetNumUninitialized(NumNodeEdges);
+	for (int32 Slot = 0; Slot < NumNodeEdges; ++Slot)
+	{
+		Scaled[Slot] = double(GetEffectiveWeight(Weights[FirstEdge + Slot])) * NumNodeEdges / TotalWeight;
+		(Scaled[Slot] < 1.0 ? Small : Large).Add(Slot);
+	}
+
+	while (!Small.IsEmpty() && !Large.IsEmpty())
+	{
+		const int32 Less = Small.Pop(EAllowShrinking::No);
+		const int32 More = Large.Pop(EAllowShrinking::No);
+
+		AliasProbabilities[FirstEdge + Less] = float(Scaled[Less]);
+		AliasSlots[FirstEdge + Less] = More;
+
+		Scaled[More] = (Scaled[More] + Scaled[Less]) - 1.0;
+		(Scaled[More] < 1.0 ? Small : Large).Add(More);
+	}
+
+	// Leftovers are full buckets, precision errors included
+	for (const int32 Slot : Large)
+	{
+		AliasProbabilities[FirstEdge + Slot] = 1.f;
+		AliasSlots[FirstEdge + Slot] = Slot;
+	}
+	for (const int32 Slot : Small)
+	{
+		AliasProbabilities[FirstEdge + Slot] = 1.f;
+		AliasSlots[FirstEdge + Slot] = Slot;
+	}
+}
@@ -9,10 +9,25 @@
 #include "Blueprint/AIBlueprintHelperLibrary.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
-#include "BBValueProvider/BBValueProvider_Base.h"
+#include "BBValueProvider/BBValue.h"
+#include "SimpleWaypointsStats.h"
 
 DEFINE_LOG_CATEGORY(LogWaypointFollower);
 
+#if !UE_BUILD_SHIPPING
+/** Message is a string literal, nothing gets formatted unless bEnableDebug is set and the category is active */
+#define WAYPOINT_DEBUG_LOG(Message) \
+	do { if (bEnableDebug && UE_LOG_ACTIVE(LogWaypointFollower, Log)) { UE_LOG(LogWaypointFollower, Log, TEXT("%s: %s"), *GetOwner()->GetActorNameOrLabel(), TEXT(Message)); } } while (0)
+#define WAYPOINT_DEBUG_LOG_WAYPOINT(Waypoint, Message) \
+	do { if (bEnableDebug && UE_LOG_ACTIVE(LogWaypointFollower, Log)) { UE_LOG(LogWaypointFollower, Log, TEXT("%s (%s): %s"), *GetOwner()->GetActorNameOrLabel(), *GetNameSafe(Waypoint), TEXT(Message)); } } while (0)
+#else
+#define WAYPOINT_DEBUG_LOG(Message)
+#define WAYPOINT_DEBUG_LOG_WAYPOINT(Waypoint, Message)
+#endif
+
+/** How many alias samples may be rejected before falling back to exhaustive filtering */
+static constexpr int32 MaxRejectedSamples = 4;
+
 UWaypointFollower::UWaypointFollower(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -25,7 +40,8 @@ void UWaypointFollower::BeginPlay()
 {
 	Super::BeginPlay();
 
-	VisitedWaypoints.Reserve(HistoryLimit);
+	VisitedIndices.Reserve(HistoryLimit);
+	VisitCounts.Reserve(HistoryLimit);
 
 	// DEMO
 	if (BTOverride)
@@ -45,12 +61,19 @@ void UWaypointFollower::BeginPlay()
 #endif
 }
 
+void UWaypointFollower::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	CurrentReservation.Release();
+	SetPinnedWaypoint(GoalWaypoint, nullptr);
+	SetPinnedWaypoint(LastReachedWaypoint, nullptr);
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void UWaypointFollower::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	TickCooldowns(DeltaTime);
-
 #if !UE_BUILD_SHIPPING
 	if (bEnableDebug)
 	{
@@ -82,10 +105,40 @@ UWaypointFollower* UWaypointFollower::GetWaypointFollower(AActor* Owner)
 	return Owner->GetComponentByClass<UWaypointFollower>();
 }
 
+void UWaypointFollower::SetWaypointGraph(AWaypointGraph* Graph)
+{
+	if (Graph != WaypointGraph)
+	{
+		if (WaypointGraph)
+		{
+			WaypointGraph->UnpinWaypoint(GoalWaypoint);
+			WaypointGraph->UnpinWaypoint(LastReachedWaypoint);
+		}
+		WaypointGraph = Graph;
+		if (WaypointGraph)
+		{
+			WaypointGraph->PinWaypoint(GoalWaypoint);
+			WaypointGraph->PinWaypoint(LastReachedWaypoint);
+		}
+		VisitedIndices.Reset();
+		VisitCounts.Reset();
+		HistoryVersion = 0;
+		IgnoredIndices.Reset();
+		CooldownVersion = 0;
+		RouteScratch.Reset();
+	}
+}
+
 void UWaypointFollower::ReachWaypoint()
 {
 	AddToHistory(CurrentWaypoint);
 
+	if (GoalWaypoint && GoalWaypoint == CurrentWaypoint)
+	{
+		WAYPOINT_DEBUG_LOG_WAYPOINT(GoalWaypoint, "Goal reached");
+		SetGoalWaypoint(nullptr);
+	}
+
 	if (AAIController* AIC = OwnerController.Get())
 	{
 		if (UBehaviorTreeComponent* BTComp = AIC->GetComponentByClass<UBehaviorTreeComponent>())
@@ -104,69 +157,176 @@ void UWaypointFollower::ReachWaypoint()
 
 AWaypoint* UWaypointFollower::SelectWaypoint()
 {
+	AWaypoint* SelectedWaypoint = nullptr;
+	TrySelectWaypoint(SelectedWaypoint, false);
+	return SelectedWaypoint;
+}
+
+bool UWaypointFollower::TrySelectWaypoint(AWaypoint*& OutWaypoint, bool bAllowPending)
+{
+	SIMPLEWAYPOINTS_SCOPE(SelectWaypoint);
+
+	FWaypointPendingSelection Selection;
+	if (BeginSelection(Selection))
+	{
+		bool bPending = false;
+		FWaypointReservation Reservation = PickDestination(*Selection.Graph, Selection.FromIndex, &bPending);
+		if (bPending && bAllowPending)
+		{
+			WAYPOINT_DEBUG_LOG("Waiting for async conditions");
+			OutWaypoint = nullptr;
+			return false;
+		}
+
+		CommitSelection(MoveTemp(Reservation));
+		Selection.Result = CurrentWaypoint;
+	}
+
+	OutWaypoint = Selection.Result;
+	return true;
+}
+
+bool UWaypointFollower::BeginSelection(FWaypointPendingSelection& OutSelection)
+{
+	OutSelection.Result = nullptr;
+
 	if (!WaypointGraph)
 	{
-#if !UE_BUILD_SHIPPING
-		DebugLog("No action graph");
-#endif
-		return nullptr;
+		WAYPOINT_DEBUG_LOG("No action graph");
+		return false;
 	}
 
 	if (!CurrentWaypoint)
 	{
 		SetCurrentWaypoint(WaypointGraph->GetNearestPoint(GetOwner()->GetActorLocation()));
-#if !UE_BUILD_SHIPPING
-		DebugLogWaypoint(CurrentWaypoint, "Picked nearest waypoint");
-#endif
-		return CurrentWaypoint;
+		WAYPOINT_DEBUG_LOG_WAYPOINT(CurrentWaypoint, "Picked nearest waypoint");
+		OutSelection.Result = CurrentWaypoint;
+		return false;
 	}
 
 	if (!IsWaypointReached(CurrentWaypoint))
 	{
-		return CurrentWaypoint;
+		OutSelection.Result = CurrentWaypoint;
+		return false;
 	}
 
-	TMap<AWaypoint*, uint8> Destinations = CurrentWaypoint->GetDestinationsCopy();
-	FilterDestinations(Destinations);
-	if (AWaypoint* SelectedWaypoint = GetRandomWaypoint(Destinations))
+	const FWaypointCompiledGraph& Graph = WaypointGraph->GetCompiledGraph();
+	const int32 CurrentIndex = CurrentWaypoint->GetGraphIndex();
+
+	OutSelection.Graph = &Graph;
+	OutSelection.FromIndex = Graph.IsValidNode(CurrentIndex) && WaypointGraph->FindWaypoint(CurrentIndex) == CurrentWaypoint ? CurrentIndex : INDEX_NONE;
+	OutSelection.Candidates.Reset();
+
+	// Goal directed mode is resolved right away, random destinations are only a detour
+	if (GoalWaypoint && OutSelection.FromIndex != INDEX_NONE)
 	{
-#if !UE_BUILD_SHIPPING
-		DebugLogWaypoint(SelectedWaypoint,"Picked randomly from destinations");
-#endif
-		SetCurrentWaypoint(SelectedWaypoint);
+		FWaypointReservation Reservation = ReserveRouteHop(OutSelection.FromIndex);
+		if (Reservation.IsValid())
+		{
+			INC_DWORD_STAT(STAT_WaypointSelections);
+			SetReservedWaypoint(MoveTemp(Reservation));
+			OutSelection.Result = CurrentWaypoint;
+			return false;
+		}
+	}
+	return true;
+}
+
+void UWaypointFollower::FilterPendingSelection(FWaypointPendingSelection& Selection) const
+{
+	SIMPLEWAYPOINTS_SCOPE(FilterDestinations);
+
+	if (Selection.FromIndex != INDEX_NONE)
+	{
+		GatherDestinations(*Selection.Graph, Selection.FromIndex, Selection.Candidates);
+		FilterDestinationsData(*Selection.Graph, Selection.Candidates);
+	}
+}
+
+bool UWaypointFollower::FinishSelection(FWaypointPendingSelection& Selection, bool bAllowPending)
+{
+	SIMPLEWAYPOINTS_SCOPE(SelectWaypoint);
+
+	const int32 NumPending = FilterDestinationsConditions(Selection.Candidates);
+	FilterDestinationsVisited(Selection.Candidates);
+
+	// Destinations could have been claimed by followers merged earlier in the same batch, TryReserve() sorts it out
+	FWaypointReservation Reservation = ReserveRandomWaypoint(Selection.Candidates);
+	if (!Reservation.IsValid() && NumPending > 0 && bAllowPending)
+	{
+		WAYPOINT_DEBUG_LOG("Waiting for async conditions");
+		Selection.Result = nullptr;
+		return false;
+	}
+
+	CommitSelection(MoveTemp(Reservation));
+	Selection.Result = CurrentWaypoint;
+	return true;
+}
+
+void UWaypointFollower::CommitSelection(FWaypointReservation&& Reservation)
+{
+	INC_DWORD_STAT(STAT_WaypointSelections);
+
+	if (Reservation.IsValid())
+	{
+		WAYPOINT_DEBUG_LOG_WAYPOINT(Reservation.GetWaypoint(), "Picked randomly from destinations");
+		SetReservedWaypoint(MoveTemp(Reservation));
 	}
 	else if (bLoopPath)
 	{
-#if !UE_BUILD_SHIPPING
-		DebugLog("No destination found, choosing first graph point");
-#endif
+		WAYPOINT_DEBUG_LOG("No destination found, choosing first graph point");
 		SetCurrentWaypoint(WaypointGraph->GetFirstPoint());
 	}
 	else
 	{
-#if !UE_BUILD_SHIPPING
-		DebugLog("No WP available");
-#endif
+		WAYPOINT_DEBUG_LOG("No WP available");
 		SetCurrentWaypoint(nullptr);
 	}
-
-	return CurrentWaypoint;
 }
 
 void UWaypointFollower::IgnoreWaypoint(AWaypoint* Waypoint)
 {
-	IgnoredWaypoints.Add(Waypoint, Waypoint->GetCooldown());
-	SetComponentTickEnabled(true);
+	if (!Waypoint || Waypoint->GetCooldown() <= 0.f || !WaypointGraph)
+	{
+		return;
+	}
+
+	// Cooldown matters only for selection from the graph, where destinations are indices
+	const FWaypointCompiledGraph& Graph = WaypointGraph->GetCompiledGraph();
+	const int32 Index = Waypoint->GetGraphIndex();
+	if (!Graph.IsValidNode(Index) || WaypointGraph->FindWaypoint(Index) != Waypoint)
+	{
+		return;
+	}
+	if (CooldownVersion != Graph.GetVersion())
+	{
+		IgnoredIndices.Reset();
+		CooldownVersion = Graph.GetVersion();
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	PruneCooldowns(Now);
+	IgnoredIndices.Add(Index, Now + Waypoint->GetCooldown());
+	INC_DWORD_STAT(STAT_WaypointCooldownEntries);
+}
+
+void UWaypointFollower::SetGoalWaypoint(AWaypoint* Goal)
+{
+	SetPinnedWaypoint(GoalWaypoint, Goal);
+	RouteScratch.Reset();
 }
 
 void UWaypointFollower::SetCurrentWaypoint(AWaypoint* Waypoint)
 {
-	if (CurrentWaypoint)
-	{
-		CurrentWaypoint->ReleaseWaypoint();
-	}
-	CurrentWaypoint = Waypoint;
-	CurrentWaypoint->OccupyWaypoint();
+	SetReservedWaypoint(Waypoint ? Waypoint->Reserve() : FWaypointReservation());
+}
+
+void UWaypointFollower::SetReservedWaypoint(FWaypointReservation&& Reservation)
+{
+	CurrentWaypoint = Reservation.GetWaypoint();
+	// Assignment releases previous reservation
+	CurrentReservation = MoveTemp(Reservation);
 }
 
 ACharacter* UWaypointFollower::GetOwnerCharacter() const
@@ -206,220 +366,401 @@ AAIController* UWaypointFollower::GetOwnerController() const
 
 /** Filtering */
 
-void UWaypointFollower::FilterDestinations(TMap<AWaypoint*, uint8>& Destinations) const
+FWaypointReservation UWaypointFollower::PickDestination(const FWaypointCompiledGraph& Graph, int32 FromIndex, bool* bOutPending) const
 {
-	if (Destinations.IsEmpty())
+	if (!Graph.IsValidNode(FromIndex) || Graph.GetNumEdges(FromIndex) <= 0)
 	{
-		return;
+		return FWaypointReservation();
 	}
 
-	// First iteration pass
-	for (auto It = Destinations.CreateIterator(); It; ++It)
+	// Fast path: alias sampling with rejection. Accepted sample follows the same distribution
+	// as the weighted pick over filtered destinations, but only sampled ones get checked
+	for (int32 Attempt = 0; Attempt < MaxRejectedSamples; ++Attempt)
 	{
-		AWaypoint* Wp = It.Key();
-
-		if (IsOnCooldown(Wp))
+		const int32 Index = Graph.SampleDestination(FromIndex);
+		if (bAvoidVisited && WasVisited(Graph, Index))
 		{
-#if !UE_BUILD_SHIPPING
-			DebugLogWaypoint(Wp, "On cooldown");
-#endif
-			It.RemoveCurrent();
+			INC_DWORD_STAT(STAT_WaypointRejectedVisited);
 			continue;
 		}
 
-		if (IsOccupied(Wp))
+		// Node waypoints are spawned only once they pass the checks
+		if (IsAvailable(Graph, Index))
 		{
-#if !UE_BUILD_SHIPPING
-			DebugLogWaypoint(Wp, "Is occupied");
-#endif
-			It.RemoveCurrent();
+			AWaypoint* Wp = WaypointGraph->GetWaypoint(Index);
+			FWaypointReservation Reservation = Wp ? Wp->TryReserve() : FWaypointReservation();
+			if (Reservation.IsValid())
+			{
+				return Reservation;
+			}
+		}
+	}
+
+	// Slow path: most destinations are unavailable, filter them all in a stack buffer
+	FWaypointCandidateArray Candidates;
+	GatherDestinations(Graph, FromIndex, Candidates);
+	const int32 NumPending = FilterDestinations(Graph, Candidates);
+
+	FWaypointReservation Reservation = ReserveRandomWaypoint(Candidates);
+	if (bOutPending)
+	{
+		*bOutPending = !Reservation.IsValid() && NumPending > 0;
+	}
+	return Reservation;
+}
+
+void UWaypointFollower::GatherDestinations(const FWaypointCompiledGraph& Graph, int32 FromIndex, FWaypointCandidateArray& OutCandidates) const
+{
+	const TConstArrayView<int32> Destinations = Graph.GetDestinations(FromIndex);
+	const TConstArrayView<uint8> Weights = Graph.GetWeights(FromIndex);
+
+	OutCandidates.Reset(Destinations.Num());
+	for (int32 i = 0; i < Destinations.Num(); ++i)
+	{
+		OutCandidates.Add({ Destinations[i], Weights[i], false });
+	}
+}
+
+int32 UWaypointFollower::FilterDestinations(const FWaypointCompiledGraph& Graph, FWaypointCandidateArray& Candidates) const
+{
+	SIMPLEWAYPOINTS_SCOPE(FilterDestinations);
+
+	FilterDestinationsData(Graph, Candidates);
+	const int32 NumPending = FilterDestinationsConditions(Candidates);
+	FilterDestinationsVisited(Candidates);
+	return NumPending;
+}
+
+void UWaypointFollower::FilterDestinationsData(const FWaypointCompiledGraph& Graph, FWaypointCandidateArray& Candidates) const
+{
+	// Runs in parallel, so it works on indices and never spawns node waypoints
+	for (int32 i = Candidates.Num() - 1; i >= 0; --i)
+	{
+		const int32 Index = Candidates[i].Index;
+
+		if (IsOnCooldown(Graph, Index))
+		{
+			INC_DWORD_STAT(STAT_WaypointRejectedCooldown);
+			WAYPOINT_DEBUG_LOG_WAYPOINT(WaypointGraph->FindWaypoint(Index), "On cooldown");
+			Candidates.RemoveAt(i, EAllowShrinking::No);
 			continue;
 		}
 
-		if (!DoesMeetConditions(Wp))
+		if (IsOccupied(Index))
 		{
-#if !UE_BUILD_SHIPPING
-			DebugLogWaypoint(Wp, "Conditions mismatch");
-#endif
-			It.RemoveCurrent();
+			INC_DWORD_STAT(STAT_WaypointRejectedOccupied);
+			WAYPOINT_DEBUG_LOG_WAYPOINT(WaypointGraph->FindWaypoint(Index), "Is occupied");
+			Candidates.RemoveAt(i, EAllowShrinking::No);
 			continue;
 		}
+
+		Candidates[i].bVisited = bAvoidVisited && WasVisited(Graph, Index);
 	}
+}
 
-	// Second iteration pass
-	if (bAvoidVisited && Destinations.Num() > 1)
+int32 UWaypointFollower::FilterDestinationsConditions(FWaypointCandidateArray& Candidates) const
+{
+	int32 NumPending = 0;
+	for (int32 i = Candidates.Num() - 1; i >= 0; --i)
 	{
-		for (auto It = Destinations.CreateIterator(); It; ++It)
+		const int32 Index = Candidates[i].Index;
+
+		const EConditionResult Result = PollConditions(Index);
+		if (Result == EConditionResult::Pending)
 		{
-			AWaypoint* Wp = It.Key();
-			if (WasVisited(Wp))
-			{
-#if !UE_BUILD_SHIPPING
-				DebugLogWaypoint(Wp, "Already visited");
-#endif
-				It.RemoveCurrent();
-				if (Destinations.Num() <= 1)
-				{
-					break;
-				}
-			}
+			INC_DWORD_STAT(STAT_WaypointRejectedPending);
+			WAYPOINT_DEBUG_LOG_WAYPOINT(WaypointGraph->FindWaypoint(Index), "Conditions pending");
+			Candidates.RemoveAt(i, EAllowShrinking::No);
+			++NumPending;
+		}
+		else if (Result == EConditionResult::False)
+		{
+			INC_DWORD_STAT(STAT_WaypointRejectedConditions);
+			WAYPOINT_DEBUG_LOG_WAYPOINT(WaypointGraph->FindWaypoint(Index), "Conditions mismatch");
+			Candidates.RemoveAt(i, EAllowShrinking::No);
+		}
+	}
+	return NumPending;
+}
+
+void UWaypointFollower::FilterDestinationsVisited(FWaypointCandidateArray& Candidates) const
+{
+	// Visited ones are skipped as long as there's something else to choose
+	for (int32 i = 0; i < Candidates.Num() && Candidates.Num() > 1;)
+	{
+		if (Candidates[i].bVisited)
+		{
+			INC_DWORD_STAT(STAT_WaypointRejectedVisited);
+			WAYPOINT_DEBUG_LOG_WAYPOINT(WaypointGraph->FindWaypoint(Candidates[i].Index), "Already visited");
+			Candidates.RemoveAt(i, EAllowShrinking::No);
+			continue;
 		}
+		++i;
 	}
 }
 
-bool UWaypointFollower::DoesMeetConditions(AWaypoint* Waypoint) const
+bool UWaypointFollower::IsAvailable(const FWaypointCompiledGraph& Graph, int32 Index, bool* bOutPending) const
 {
-	return Waypoint->CheckConditions(GetOwner());
+	if (IsOnCooldown(Graph, Index))
+	{
+		INC_DWORD_STAT(STAT_WaypointRejectedCooldown);
+		WAYPOINT_DEBUG_LOG_WAYPOINT(WaypointGraph->FindWaypoint(Index), "On cooldown");
+		return false;
+	}
+
+	if (IsOccupied(Index))
+	{
+		INC_DWORD_STAT(STAT_WaypointRejectedOccupied);
+		WAYPOINT_DEBUG_LOG_WAYPOINT(WaypointGraph->FindWaypoint(Index), "Is occupied");
+		return false;
+	}
+
+	const EConditionResult Result = PollConditions(Index);
+	if (Result == EConditionResult::Pending)
+	{
+		INC_DWORD_STAT(STAT_WaypointRejectedPending);
+		WAYPOINT_DEBUG_LOG_WAYPOINT(WaypointGraph->FindWaypoint(Index), "Conditions pending");
+		if (bOutPending)
+		{
+			*bOutPending = true;
+		}
+		return false;
+	}
+
+	if (Result == EConditionResult::False)
+	{
+		INC_DWORD_STAT(STAT_WaypointRejectedConditions);
+		WAYPOINT_DEBUG_LOG_WAYPOINT(WaypointGraph->FindWaypoint(Index), "Conditions mismatch");
+		return false;
+	}
+
+	return true;
 }
 
-bool UWaypointFollower::IsOnCooldown(AWaypoint* Waypoint) const
+EConditionResult UWaypointFollower::PollConditions(int32 Index) const
 {
-	if (IgnoredWaypoints.Contains(Waypoint))
+	if (!WaypointGraph->PointHasConditions(Index))
 	{
-		return true;
+		return EConditionResult::True;
 	}
-	
-	return false;
+
+	// Conditions are compiled and cached by the actor, so nodes with conditions need one
+	AWaypoint* Waypoint = WaypointGraph->GetWaypoint(Index);
+	return Waypoint ? Waypoint->PollConditions(GetOwner()) : EConditionResult::False;
 }
 
-bool UWaypointFollower::IsOccupied(AWaypoint* Waypoint) const
+bool UWaypointFollower::IsOnCooldown(const FWaypointCompiledGraph& Graph, int32 Index) const
 {
-	if (Waypoint->IsPointOccupied())
+	if (CooldownVersion != Graph.GetVersion())
 	{
-		return true;
+		return false;
 	}
 
-	return false;
+	const double* CooldownEnd = IgnoredIndices.Find(Index);
+	return CooldownEnd && *CooldownEnd > GetWorld()->GetTimeSeconds();
+}
+
+bool UWaypointFollower::IsOccupied(int32 Index) const
+{
+	return WaypointGraph->IsPointOccupied(Index);
 }
 
-bool UWaypointFollower::WasVisited(AWaypoint* Waypoint) const
+bool UWaypointFollower::WasVisited(const FWaypointCompiledGraph& Graph, int32 Index) const
 {
-	if (VisitedWaypoints.Contains(Waypoint))
+	if (HistoryVersion != Graph.GetVersion())
 	{
-		return true;
+		return false;
 	}
 
-	return false;
+	return VisitCounts.Contains(Index);
 }
 
-AWaypoint* UWaypointFollower::GetRandomWaypoint(TMap<AWaypoint*, uint8>& Destinations) const
+int32 UWaypointFollower::GetRandomCandidate(const FWaypointCandidateArray& Candidates) const
 {
-	if (!Destinations.Num())
+	if (!Candidates.Num())
 	{
-		return nullptr;
+		return INDEX_NONE;
 	}
 
 	int32 TotalWeight = 0;
 
-	for (const auto& Destination : Destinations)
+	for (const FWaypointCandidate& Candidate : Candidates)
 	{
-		TotalWeight += Destination.Value;
+		TotalWeight += FWaypointCompiledGraph::GetEffectiveWeight(Candidate.Weight);
 	}
 
-	int32 RandomWeight = FMath::RandRange(0, TotalWeight);
+	const int32 RandomWeight = FMath::RandRange(0, TotalWeight - 1);
 	TotalWeight = 0;
 
-	for (const auto& Destination : Destinations)
+	for (int32 i = 0; i < Candidates.Num(); ++i)
 	{
-		TotalWeight += Destination.Value;
-		if (TotalWeight >= RandomWeight)
+		TotalWeight += FWaypointCompiledGraph::GetEffectiveWeight(Candidates[i].Weight);
+		if (TotalWeight > RandomWeight)
 		{
-			return Destination.Key;
+			return i;
 		}
 	}
 
 	ensure(false); // Something went wrong
-	return nullptr;
+	return INDEX_NONE;
 }
 
-/** History */
-
-void UWaypointFollower::AddToHistory(AWaypoint* Waypoint)
+FWaypointReservation UWaypointFollower::ReserveRandomWaypoint(FWaypointCandidateArray& Candidates) const
 {
-	if (VisitedWaypoints.Num() == (HistoryLimit))
+	while (!Candidates.IsEmpty())
 	{
-		VisitedWaypoints.RemoveAt(0, EAllowShrinking::No);
+		const int32 CandidateIndex = GetRandomCandidate(Candidates);
+		if (!Candidates.IsValidIndex(CandidateIndex))
+		{
+			break;
+		}
+
+		// Node waypoint of the picked candidate is spawned here, on game thread
+		AWaypoint* Wp = WaypointGraph->GetWaypoint(Candidates[CandidateIndex].Index);
+		FWaypointReservation Reservation = Wp ? Wp->TryReserve() : FWaypointReservation();
+		if (Reservation.IsValid())
+		{
+			return Reservation;
+		}
+
+		// Claimed by someone else in the meantime
+		Candidates.RemoveAt(CandidateIndex, EAllowShrinking::No);
 	}
-	VisitedWaypoints.Add(Waypoint);
-}
 
-/** Cooldown */
+	return FWaypointReservation();
+}
 
-void UWaypointFollower::TickCooldowns(float DeltaTime)
+FWaypointReservation UWaypointFollower::ReserveRouteHop(int32 FromIndex)
 {
-	for (TMap<AWaypoint*, float>::TIterator It(IgnoredWaypoints); It; ++It)
+	const int32 GoalIndex = GoalWaypoint->GetGraphIndex();
+	if (WaypointGraph->FindWaypoint(GoalIndex) != GoalWaypoint)
+	{
+		WAYPOINT_DEBUG_LOG_WAYPOINT(GoalWaypoint, "Goal isn't part of the graph");
+		SetGoalWaypoint(nullptr);
+		return FWaypointReservation();
+	}
+	if (GoalIndex == FromIndex)
+	{
+		WAYPOINT_DEBUG_LOG_WAYPOINT(GoalWaypoint, "Goal reached");
+		SetGoalWaypoint(nullptr);
+		return FWaypointReservation();
+	}
+
+	const int32 HopIndex = WaypointGraph->GetRouteTable().GetNextHop(FromIndex, GoalIndex, RouteScratch);
+	if (HopIndex == INDEX_NONE)
 	{
-		It->Value -= DeltaTime;
-		if (It->Value <= 0.f)
+		WAYPOINT_DEBUG_LOG_WAYPOINT(GoalWaypoint, "Goal unreachable");
+		SetGoalWaypoint(nullptr);
+		return FWaypointReservation();
+	}
+
+	if (IsAvailable(WaypointGraph->GetCompiledGraph(), HopIndex))
+	{
+		AWaypoint* Hop = WaypointGraph->GetWaypoint(HopIndex);
+		FWaypointReservation Reservation = Hop ? Hop->TryReserve() : FWaypointReservation();
+		if (Reservation.IsValid())
 		{
-			It.RemoveCurrent();
+			WAYPOINT_DEBUG_LOG_WAYPOINT(Hop, "Next waypoint of the route to goal");
+			return Reservation;
 		}
 	}
 
-#if !UE_BUILD_SHIPPING
-	// We want to keep tick enabled for debug purposes
-	if (bEnableDebug)
+	WAYPOINT_DEBUG_LOG_WAYPOINT(WaypointGraph->FindWaypoint(HopIndex), "Next waypoint of the route unavailable, taking a detour");
+	return FWaypointReservation();
+}
+
+/** History */
+
+void UWaypointFollower::AddToHistory(AWaypoint* Waypoint)
+{
+	SetPinnedWaypoint(LastReachedWaypoint, Waypoint);
+
+	if (!WaypointGraph || !Waypoint || HistoryLimit <= 0)
 	{
 		return;
 	}
-#endif
 
-	if (IgnoredWaypoints.IsEmpty())
+	// Dense indices change with recompilation, so the history doesn't survive it
+	const FWaypointCompiledGraph& Graph = WaypointGraph->GetCompiledGraph();
+	if (HistoryVersion != Graph.GetVersion())
 	{
-		SetComponentTickEnabled(false);
+		VisitedIndices.Reset();
+		VisitCounts.Reset();
+		HistoryVersion = Graph.GetVersion();
 	}
-}
 
-bool UWaypointFollower::IsWaypointReached(AWaypoint* Waypoint) const
-{
-	if (VisitedWaypoints.IsEmpty())
+	const int32 Index = Waypoint->GetGraphIndex();
+	if (!Graph.IsValidNode(Index))
 	{
-		return false;
+		return;
 	}
-	else
+
+	while (VisitedIndices.Num() >= HistoryLimit)
 	{
-		if (VisitedWaypoints.Last() == CurrentWaypoint)
-		{
-			return true;
-		}
-		else
+		const int32 Oldest = VisitedIndices.PopFrontValue();
+		uint16& Count = VisitCounts.FindChecked(Oldest);
+		if (--Count == 0)
 		{
-			return false;
+			VisitCounts.Remove(Oldest);
 		}
 	}
+	VisitedIndices.Add(Index);
+	// Count fits, HistoryLimit is clamped to 65535
+	++VisitCounts.FindOrAdd(Index, 0);
 }
 
-void UWaypointFollower::SetWaypointBehaviorParameters(AWaypoint* Waypoint)
+void UWaypointFollower::GetVisitedWaypoints(TArray<AWaypoint*>& OutWaypoints) const
 {
-	if (OwnerController.IsValid())
+	OutWaypoints.Reset(VisitedIndices.Num());
+	for (int32 i = 0; i < VisitedIndices.Num(); ++i)
 	{
-		if (UBlackboardComponent* BB = OwnerController.Get()->GetBlackboardComponent())
-		{
-			TArray<UBBValueProvider_Base*> Params = Waypoint->GetBehaviorParams();
-			if (!Params.IsEmpty())
-			{
-				for (const auto& Param : Waypoint->GetBehaviorParams())
-				{
-					Param->SetBlackboardValue(BB);
-				}
-			}
-		}
+		OutWaypoints.Add(WaypointGraph ? WaypointGraph->FindWaypoint(VisitedIndices[i]) : nullptr);
 	}
 }
 
-#if !UE_BUILD_SHIPPING
-void UWaypointFollower::DebugLog(FString Message) const
+void UWaypointFollower::SetPinnedWaypoint(TObjectPtr<AWaypoint>& Slot, AWaypoint* Waypoint)
 {
-	if (bEnableDebug)
+	if (Slot == Waypoint)
+	{
+		return;
+	}
+
+	if (WaypointGraph)
 	{
-		UE_LOG(LogWaypointFollower, Log, TEXT("%s: %s"), *GetOwner()->GetActorLabel(), *Message);
+		WaypointGraph->UnpinWaypoint(Slot);
+		WaypointGraph->PinWaypoint(Waypoint);
 	}
+	Slot = Waypoint;
 }
-void UWaypointFollower::DebugLogWaypoint(AWaypoint* Waypoint, FString Message) const
+
+/** Cooldown */
+
+void UWaypointFollower::PruneCooldowns(double Now)
 {
-	if (bEnableDebug)
+	for (TMap<int32, double>::TIterator It(IgnoredIndices); It; ++It)
 	{
-		UE_LOG(LogWaypointFollower, Log, TEXT("%s (%s): %s"), *GetOwner()->GetActorLabel(), *Waypoint->GetActorLabel(), *Message);
+		if (It->Value <= Now)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool UWaypointFollower::IsWaypointReached(AWaypoint* Waypoint) const
+{
+	return LastReachedWaypoint && LastReachedWaypoint == CurrentWaypoint;
+}
+
+void UWaypointFollower::SetWaypointBehaviorParameters(AWaypoint* Waypoint)
+{
+	SIMPLEWAYPOINTS_SCOPE(SetWaypointBehaviorParameters);
+
+	if (OwnerController.IsValid())
+	{
+		if (UBlackboardComponent* BB = OwnerController.Get()->GetBlackboardComponent())
+		{
+			// One transaction, so observing decorators are notified once per key
+			FBBValue::SetBlackboardValues(BB, Waypoint->GetBehaviorParams());
+		}
 	}
 }
-#endif
\ No newline at end of file
@@ -3,9 +3,23 @@
 
 #include "Objects/WaypointGraph.h"
 #include "Objects/Waypoint.h"
+#include "Objects/WaypointNode.h"
+#include "Objects/WaypointGraphVisualizer.h"
+#include "SimpleWaypointsStats.h"
 #include "Components/BillboardComponent.h"
 #include "Components/TextRenderComponent.h"
 #include "Components/LineBatchComponent.h"
+#include "UObject/ObjectSaveContext.h"
+#include "HAL/IConsoleManager.h"
+#include "TimerManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWaypointGraph, Log, All);
+
+static TAutoConsoleVariable<float> CVarNodeWaypointReleaseInterval(
+	TEXT("SimpleWaypoints.NodeWaypointReleaseInterval"),
+	10.f,
+	TEXT("Seconds between checks for unused node waypoint actors. Actors without users on two checks in a row are destroyed, 0 keeps them alive. Read on BeginPlay."),
+	ECVF_Default);
 
 AWaypointGraph::AWaypointGraph()
 {
@@ -32,6 +46,13 @@ AWaypointGraph::AWaypointGraph()
 		TextComponent->SetRelativeLocation(FVector(0.f, 0.f, 100.f));
 		TextComponent->SetupAttachment(RootComponent);
 	}
+
+	// Setup visualization
+	Visualizer = CreateEditorOnlyDefaultSubobject<UWaypointGraphVisualizer>(FName("Visualizer"));
+	if (Visualizer)
+	{
+		Visualizer->SetupAttachment(RootComponent);
+	}
 #endif
 
 	// Tick setup
@@ -48,42 +69,328 @@ void AWaypointGraph::CreateWaypoint()
 	NewWaypoint->AttachToActor(this, FAttachmentTransformRules(EAttachmentRule::SnapToTarget, false));
 }
 
+#if WITH_EDITOR
+void AWaypointGraph::CollapseWaypoints()
+{
+	Modify();
+
+	// Collapsed waypoints are appended after existing nodes
+	TMap<const AWaypoint*, int32> NodeIndices;
+	const TArray<AWaypoint*> Collapsed = Waypoints.FilterByPredicate([](const AWaypoint* Waypoint) { return Waypoint != nullptr; });
+	for (int32 i = 0; i < Collapsed.Num(); ++i)
+	{
+		NodeIndices.Add(Collapsed[i], Nodes.Num() + i);
+	}
+
+	for (const AWaypoint* Waypoint : Collapsed)
+	{
+		FWaypointNode& Node = Nodes.AddDefaulted_GetRef();
+		Waypoint->ToNode(Node, this);
+		Node.Location = GetActorTransform().InverseTransformPosition(Waypoint->GetActorLocation());
+		for (const auto& Destination : Waypoint->ViewDestinations())
+		{
+			if (const int32* DestinationNode = NodeIndices.Find(Destination.Key))
+			{
+				Node.Destinations.Add({ *DestinationNode, Destination.Value });
+			}
+		}
+	}
+
+	for (AWaypoint* Waypoint : Collapsed)
+	{
+		Waypoint->Destroy();
+	}
+	Waypoints.Reset();
+	InvalidateCompiledGraph();
+}
+
+void AWaypointGraph::ExpandNodes()
+{
+	UWorld* World = GetWorld();
+	if (!World || Nodes.IsEmpty())
+	{
+		return;
+	}
+
+	Modify();
+
+	TArray<AWaypoint*> Expanded;
+	Expanded.Reserve(Nodes.Num());
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); ++NodeIndex)
+	{
+		FActorSpawnParameters Params;
+		Params.Owner = this;
+		Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		AWaypoint* Waypoint = World->SpawnActor<AWaypoint>(DefaultWaypointClass, GetActorTransform().TransformPosition(Nodes[NodeIndex].Location), FRotator::ZeroRotator, Params);
+		if (Waypoint)
+		{
+			Waypoint->InitFromNode(Nodes[NodeIndex]);
+			Waypoint->AttachToActor(this, FAttachmentTransformRules::KeepWorldTransform);
+		}
+		Expanded.Add(Waypoint);
+	}
+
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); ++NodeIndex)
+	{
+		if (AWaypoint* Waypoint = Expanded[NodeIndex])
+		{
+			for (const FWaypointNodeDestination& Destination : Nodes[NodeIndex].Destinations)
+			{
+				if (Expanded.IsValidIndex(Destination.Node) && Expanded[Destination.Node])
+				{
+					Waypoint->SetDestination(Expanded[Destination.Node], Destination.Weight);
+				}
+			}
+		}
+	}
+
+	Nodes.Reset();
+	InvalidateCompiledGraph();
+}
+#endif
+
 AWaypoint* AWaypointGraph::GetRandomPoint() const
 {
-	return Waypoints[FMath::RandRange(0, Waypoints.Num() - 1)];
+	return GetWaypoint(FMath::RandRange(0, GetNumPoints() - 1));
+}
+
+AWaypoint* AWaypointGraph::GetWaypoint(int32 Index) const
+{
+	if (Waypoints.IsValidIndex(Index))
+	{
+		return Waypoints[Index];
+	}
+
+	const int32 NodeIndex = Index - Waypoints.Num();
+	if (!Nodes.IsValidIndex(NodeIndex))
+	{
+		return nullptr;
+	}
+
+	if (AWaypoint* Waypoint = FindWaypoint(Index))
+	{
+		return Waypoint;
+	}
+
+	// Parallel selection filters nodes by index, only the picked ones get spawned here
+	if (!ensureMsgf(IsInGameThread(), TEXT("%s: node waypoints can be spawned on game thread only"), *GetName()))
+	{
+		return nullptr;
+	}
+	if (NodeWaypoints.Num() != Nodes.Num())
+	{
+		NodeWaypoints.SetNum(Nodes.Num());
+	}
+	// Spawning the node's actor doesn't change the graph as seen from outside
+	NodeWaypoints[NodeIndex] = const_cast<AWaypointGraph*>(this)->SpawnNodeWaypoint(NodeIndex);
+	return NodeWaypoints[NodeIndex].Get();
+}
+
+AWaypoint* AWaypointGraph::FindWaypoint(int32 Index) const
+{
+	if (Waypoints.IsValidIndex(Index))
+	{
+		return Waypoints[Index];
+	}
+
+	const int32 NodeIndex = Index - Waypoints.Num();
+	return NodeWaypoints.IsValidIndex(NodeIndex) ? NodeWaypoints[NodeIndex].Get() : nullptr;
+}
+
+void AWaypointGraph::PinWaypoint(const AWaypoint* Waypoint)
+{
+	if (Waypoint)
+	{
+		++PinnedWaypoints.FindOrAdd(Waypoint, 0);
+	}
+}
+
+void AWaypointGraph::UnpinWaypoint(const AWaypoint* Waypoint)
+{
+	if (!Waypoint)
+	{
+		return;
+	}
+
+	// WaypointGraph property of followers can be switched from blueprints without moving the pins
+	int32* Pins = PinnedWaypoints.Find(Waypoint);
+	if (Pins && --(*Pins) == 0)
+	{
+		PinnedWaypoints.Remove(Waypoint);
+	}
+}
+
+bool AWaypointGraph::IsPointOccupied(int32 Index) const
+{
+	if (const AWaypoint* Waypoint = FindWaypoint(Index))
+	{
+		return Waypoint->IsPointOccupied();
+	}
+
+	// Users always hold the actor, so a node without one has none
+	const int32 NodeIndex = Index - Waypoints.Num();
+	return Nodes.IsValidIndex(NodeIndex) && Nodes[NodeIndex].MaxUsers == 0;
+}
+
+bool AWaypointGraph::PointHasConditions(int32 Index) const
+{
+	if (Waypoints.IsValidIndex(Index))
+	{
+		return Waypoints[Index]->HasConditions();
+	}
+
+	const int32 NodeIndex = Index - Waypoints.Num();
+	return Nodes.IsValidIndex(NodeIndex) && !Nodes[NodeIndex].UseConditions.IsEmpty();
+}
+
+FVector AWaypointGraph::GetPointLocation(int32 Index) const
+{
+	if (Waypoints.IsValidIndex(Index))
+	{
+		return Waypoints[Index]->GetActorLocation();
+	}
+	return GetActorTransform().TransformPosition(Nodes[Index - Waypoints.Num()].Location);
+}
+
+AWaypoint* AWaypointGraph::SpawnNodeWaypoint(int32 NodeIndex)
+{
+	UWorld* World = GetWorld();
+	if (!World || !World->IsGameWorld())
+	{
+		return nullptr;
+	}
+
+	const FTransform SpawnTransform(GetPointLocation(Waypoints.Num() + NodeIndex));
+	FActorSpawnParameters Params;
+	Params.Owner = this;
+	Params.ObjectFlags |= RF_Transient;
+	Params.bDeferConstruction = true;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	// Not attached, so it doesn't end up in Waypoints
+	AWaypoint* Waypoint = World->SpawnActor<AWaypoint>(DefaultWaypointClass, SpawnTransform, Params);
+	if (Waypoint)
+	{
+		Waypoint->InitFromNode(Nodes[NodeIndex]);
+		Waypoint->SetGraphIndex(Waypoints.Num() + NodeIndex);
+		Waypoint->FinishSpawning(SpawnTransform);
+	}
+	return Waypoint;
+}
+
+void AWaypointGraph::AssignNodeIndices()
+{
+	NodeWaypoints.SetNum(Nodes.Num());
+	for (int32 NodeIndex = 0; NodeIndex < NodeWaypoints.Num(); ++NodeIndex)
+	{
+		if (AWaypoint* Waypoint = NodeWaypoints[NodeIndex].Get())
+		{
+			Waypoint->SetGraphIndex(Waypoints.Num() + NodeIndex);
+		}
+	}
 }
 
 AWaypoint* AWaypointGraph::GetFarthestPoint(const FVector& ToLocation) const
 {
-	TArray<AWaypoint*> SortedPoints = Waypoints;
-	SortedPoints.Sort([ToLocation](AWaypoint& a, AWaypoint& b)
+	if (IsSpatialIndexValid())
+	{
+		return GetWaypoint(SpatialIndex.FindFarthest(ToLocation));
+	}
+
+	AWaypoint* FarthestPoint = nullptr;
+	double FarthestDistSq = -1.0;
+	for (AWaypoint* Waypoint : Waypoints)
+	{
+		const double DistSq = (Waypoint->GetActorLocation() - ToLocation).SizeSquared();
+		if (DistSq > FarthestDistSq)
 		{
-			float DistanceA = (a.GetActorLocation() - ToLocation).SizeSquared();
-			float DistanceB = (b.GetActorLocation() - ToLocation).SizeSquared();
-			return DistanceA > DistanceB;
-		});
+			FarthestDistSq = DistSq;
+			FarthestPoint = Waypoint;
+		}
+	}
 
-	return SortedPoints[0];
+	return FarthestPoint;
 }
 
 AWaypoint* AWaypointGraph::GetNearestPoint(const FVector& ToLocation) const
 {
-	TArray<AWaypoint*> SortedPoints = Waypoints;
-	SortedPoints.Sort([&ToLocation](AWaypoint& a, AWaypoint& b)
+	SIMPLEWAYPOINTS_SCOPE(GetNearestPoint);
+
+	if (IsSpatialIndexValid())
+	{
+		return GetWaypoint(SpatialIndex.FindNearest(ToLocation));
+	}
+
+	AWaypoint* NearestPoint = nullptr;
+	double NearestDistSq = TNumericLimits<double>::Max();
+	for (AWaypoint* Waypoint : Waypoints)
+	{
+		const double DistSq = (Waypoint->GetActorLocation() - ToLocation).SizeSquared();
+		if (DistSq < NearestDistSq)
+		{
+			NearestDistSq = DistSq;
+			NearestPoint = Waypoint;
+		}
+	}
+
+	return NearestPoint;
+}
+
+void AWaypointGraph::GetNearestPoints(const FVector& ToLocation, int32 Count, TArray<AWaypoint*>& OutWaypoints) const
+{
+	OutWaypoints.Reset();
+
+	TArray<int32, TInlineAllocator<16>> Indices;
+	Indices.SetNumUninitialized(FMath::Clamp(Count, 0, GetNumPoints()));
+	Indices.SetNum(GetNearestPointIndices(ToLocation, Indices));
+
+	OutWaypoints.Reserve(Indices.Num());
+	for (const int32 Index : Indices)
+	{
+		if (AWaypoint* Waypoint = GetWaypoint(Index))
+		{
+			OutWaypoints.Add(Waypoint);
+		}
+	}
+}
+
+int32 AWaypointGraph::GetNearestPointIndices(const FVector& ToLocation, TArrayView<int32> OutIndices) const
+{
+	if (IsSpatialIndexValid())
+	{
+		return SpatialIndex.FindKNearest(ToLocation, OutIndices);
+	}
+
+	// Fallback for editor queries, when the index isn't built yet
+	TArray<int32> SortedIndices;
+	SortedIndices.Reserve(Waypoints.Num());
+	for (int32 i = 0; i < Waypoints.Num(); ++i)
+	{
+		SortedIndices.Add(i);
+	}
+	SortedIndices.Sort([this, &ToLocation](int32 A, int32 B)
 		{
-			float DistanceA = (a.GetActorLocation() - ToLocation).SizeSquared();
-			float DistanceB = (b.GetActorLocation() - ToLocation).SizeSquared();
-			return DistanceA < DistanceB;
+			return (Waypoints[A]->GetActorLocation() - ToLocation).SizeSquared() < (Waypoints[B]->GetActorLocation() - ToLocation).SizeSquared();
 		});
 
-	return SortedPoints[0];
+	const int32 Count = FMath::Min(OutIndices.Num(), SortedIndices.Num());
+	for (int32 i = 0; i < Count; ++i)
+	{
+		OutIndices[i] = SortedIndices[i];
+	}
+	return Count;
 }
 
 void AWaypointGraph::AddWaypoint(AWaypoint* NewWaypoint)
 {
-	if (NewWaypoint)
+	if (NewWaypoint && !Waypoints.Contains(NewWaypoint))
 	{
-		Waypoints.AddUnique(NewWaypoint);
+		Waypoints.Add(NewWaypoint);
+		InvalidateCompiledGraph();
+		if (HasActorBegunPlay())
+		{
+			RebuildSpatialIndex();
+		}
 	}
 }
 
@@ -92,14 +399,139 @@ void AWaypointGraph::RemoveWaypoint(AWaypoint* Waypoint)
 	if (Waypoint)
 	{
 		Waypoints.Remove(Waypoint);
+		Waypoint->SetGraphIndex(INDEX_NONE);
+		Waypoint->SetMeshVisible(true);
+		InvalidateCompiledGraph();
+		if (HasActorBegunPlay())
+		{
+			RebuildSpatialIndex();
+		}
+	}
+}
+
+void AWaypointGraph::MarkVisualizationDirty()
+{
+#if WITH_EDITORONLY_DATA
+	if (Visualizer)
+	{
+		Visualizer->MarkVisualizationDirty();
+	}
+#endif
+}
+
+void AWaypointGraph::RebuildSpatialIndex()
+{
+	TArray<FVector> Locations;
+	Locations.Reserve(GetNumPoints());
+	for (int32 Index = 0; Index < GetNumPoints(); ++Index)
+	{
+		Locations.Add(GetPointLocation(Index));
+	}
+
+	SpatialIndex.Build(Locations);
+}
+
+const FWaypointCompiledGraph& AWaypointGraph::GetCompiledGraph()
+{
+	if (bCompiledGraphLoaded)
+	{
+		AdoptLoadedGraph();
+	}
+	if (bCompiledGraphDirty)
+	{
+		CompileGraph();
+	}
+	return CompiledGraph;
+}
+
+const FWaypointRouteTable& AWaypointGraph::GetRouteTable()
+{
+	const FWaypointCompiledGraph& Graph = GetCompiledGraph();
+	if (bRouteTableDirty)
+	{
+		RouteTable.Build(Graph, Waypoints, Nodes, GetActorTransform());
+		bRouteTableDirty = false;
+	}
+	return RouteTable;
+}
+
+void AWaypointGraph::UpdateWaypointRouting(AWaypoint* Waypoint)
+{
+	// Table that isn't built yet picks the state up when it is
+	if (bCompiledGraphDirty || bRouteTableDirty || !Waypoint)
+	{
+		return;
+	}
+
+	MarkVisualizationDirty();
+
+	const int32 Index = Waypoint->GetGraphIndex();
+	if (FindWaypoint(Index) == Waypoint)
+	{
+		RouteTable.SetNodeEnabled(Index, Waypoint->IsPointEnabled());
+		RouteTable.SetNodeCostScale(Index, Waypoint->GetRouteCostScale());
+	}
+}
+
+void AWaypointGraph::CompileGraph()
+{
+	CompiledGraph.Compile(Waypoints, Nodes);
+	AssignNodeIndices();
+	bCompiledGraphDirty = false;
+	bCompiledGraphLoaded = false;
+	bRouteTableDirty = true;
+}
+
+void AWaypointGraph::AdoptLoadedGraph()
+{
+	bCompiledGraphLoaded = false;
+
+	// Cooked graphs were compiled on save, editor ones may have been saved before their waypoints
+	const bool bCheckHash = !FPlatformProperties::RequiresCookedData();
+	if (!CompiledGraph.IsCompiledFrom(Waypoints, Nodes, bCheckHash))
+	{
+		bCompiledGraphDirty = true;
+		return;
 	}
+
+	FWaypointCompiledGraph::AssignGraphIndices(Waypoints);
+	AssignNodeIndices();
+	bCompiledGraphDirty = false;
+	bRouteTableDirty = true;
 }
 
 void AWaypointGraph::BeginPlay()
 {
 	Super::BeginPlay();
 
-	GraphComponent->SetComponentTickEnabled(false);
+	RebuildSpatialIndex();
+	GetCompiledGraph();
+
+	const float ReleaseInterval = CVarNodeWaypointReleaseInterval.GetValueOnGameThread();
+	if (!Nodes.IsEmpty() && ReleaseInterval > 0.f)
+	{
+		GetWorldTimerManager().SetTimer(ReleaseNodeWaypointsTimer, this, &AWaypointGraph::ReleaseUnusedNodeWaypoints, ReleaseInterval, true);
+	}
+}
+
+void AWaypointGraph::ReleaseUnusedNodeWaypoints()
+{
+	IdleNodeWaypoints.SetNum(NodeWaypoints.Num(), false);
+	for (int32 NodeIndex = 0; NodeIndex < NodeWaypoints.Num(); ++NodeIndex)
+	{
+		AWaypoint* Waypoint = NodeWaypoints[NodeIndex].Get();
+		const FWaypointNode& Node = Nodes[NodeIndex];
+		// Routing state changed during play lives only in the actor, such ones are kept. So are followers' goals and last reached points
+		bool bIdle = Waypoint && Waypoint->GetCurrentUsers() == 0 && !PinnedWaypoints.Contains(Waypoint)
+			&& Waypoint->IsPointEnabled() == Node.bIsEnabled && Waypoint->GetRouteCostScale() == Node.RouteCostScale;
+		if (bIdle && IdleNodeWaypoints[NodeIndex])
+		{
+			Waypoint->Destroy();
+			NodeWaypoints[NodeIndex].Reset();
+			bIdle = false;
+		}
+		IdleNodeWaypoints[NodeIndex] = bIdle;
+	}
 }
 
 void AWaypointGraph::PostLoad()
@@ -112,7 +544,85 @@ void AWaypointGraph::PostLoad()
 	});
 }
 
+void AWaypointGraph::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	Ar.UsingCustomVersion(FWaypointGraphCustomVersion::GUID);
+	if (Ar.IsObjectReferenceCollector() || Ar.CustomVer(FWaypointGraphCustomVersion::GUID) < FWaypointGraphCustomVersion::CompiledGraphBlob)
+	{
+		return;
+	}
+
+	Ar << CompiledGraph;
+	if (Ar.IsLoading())
+	{
+		bCompiledGraphLoaded = true;
+		bCompiledGraphDirty = false;
+	}
+}
+
 #if WITH_EDITOR
+void AWaypointGraph::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+
+	// Destinations can change without invalidating the graph, so the hash decides
+	GetCompiledGraph();
+	if (!CompiledGraph.IsCompiledFrom(Waypoints, Nodes, true))
+	{
+		CompileGraph();
+	}
+	ValidateCompiledGraph();
+}
+
+void AWaypointGraph::ValidateCompiledGraph() const
+{
+	const int32 NumNodes = CompiledGraph.NumNodes();
+	if (NumNodes == 0)
+	{
+		return;
+	}
+
+	const auto GetPointName = [this](int32 Index)
+	{
+		return Waypoints.IsValidIndex(Index) ? GetNameSafe(Waypoints[Index]) : FString::Printf(TEXT("Node %d"), Index - Waypoints.Num());
+	};
+
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		if (CompiledGraph.GetNumEdges(Node) == 0)
+		{
+			UE_LOG(LogWaypointGraph, Warning, TEXT("%s: %s has no destinations, followers will stop there"), *GetActorNameOrLabel(), *GetPointName(Node));
+		}
+	}
+
+	// Followers start from the first waypoint unless placed elsewhere, so that's where reachability is checked from
+	TBitArray<> Reached(false, NumNodes);
+	TArray<int32> Stack;
+	Stack.Add(0);
+	Reached[0] = true;
+	while (!Stack.IsEmpty())
+	{
+		for (const int32 Destination : CompiledGraph.GetDestinations(Stack.Pop(EAllowShrinking::No)))
+		{
+			if (!Reached[Destination])
+			{
+				Reached[Destination] = true;
+				Stack.Add(Destination);
+			}
+		}
+	}
+
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		if (!Reached[Node])
+		{
+			UE_LOG(LogWaypointGraph, Warning, TEXT("%s: %s can't be reached from %s"), *GetActorNameOrLabel(), *GetPointName(Node), *GetPointName(0));
+		}
+	}
+}
+
 void AWaypointGraph::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	Super::PostEditChangeProperty(PropertyChangedEvent);
@@ -123,6 +633,23 @@ void AWaypointGraph::PostEditChangeProperty(FPropertyChangedEvent& PropertyChang
 		TextComponent->SetText(FText::FromString(GetActorLabel()));
 	}
 #endif // With editor
+
+	// Nodes, visualizer settings
+	MarkVisualizationDirty();
+}
+
+void AWaypointGraph::PostEditMove(bool bFinished)
+{
+	Super::PostEditMove(bFinished);
+
+	MarkVisualizationDirty();
+}
+
+void AWaypointGraph::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	InvalidateCompiledGraph();
 }
 #endif // With Editoronly data
 
@@ -130,9 +657,7 @@ void AWaypointGraph::PostEditChangeProperty(FPropertyChangedEvent& PropertyChang
 
 UWaypointGraphComponent::UWaypointGraphComponent()
 {
-	PrimaryComponentTick.bCanEverTick = true;
-	PrimaryComponentTick.bStartWithTickEnabled = true;
-	bTickInEditor = true;
+	PrimaryComponentTick.bCanEverTick = false;
 }
 
 void UWaypointGraphComponent::OnChildAttached(USceneComponent* ChildComponent)
@@ -172,43 +697,3 @@ void UWaypointGraphComponent::OnRegister()
 		OwnerGraph = Cast<AWaypointGraph>(GetOwner());
 	}
 }
-
-void UWaypointGraphComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-#if WITH_EDITOR
-	DrawArrows();
-#endif
-}
-
-void UWaypointGraphComponent::DrawArrows()
-{
-	if (!GetWorld())
-	{
-		return;
-	}
-	if (AWaypointGraph* Graph = OwnerGraph.Get())
-	{
-		// Draw all destinations if waypoint graph is selected
-		if (Graph->IsSelected())
-		{
-			for (const auto& Waypoint : Graph->Waypoints)
-			{
-				Waypoint->DrawDestinationsArrows();
-			}
-		}
-		// Draw destinations only for selected waypoints
-		else
-		{
-			for (const auto& Waypoint : Graph->Waypoints)
-			{
-				if (Waypoint->IsSelected())
-				{
-					Waypoint->DrawDestinationsArrows();
-				}
-			}
-		}
-		
-	}
-}
\ No newline at end of file
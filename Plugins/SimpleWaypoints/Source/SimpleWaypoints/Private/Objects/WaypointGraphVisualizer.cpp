@@ -0,0 +1,269 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+
+#include "Objects/WaypointGraphVisualizer.h"
+#include "Objects/WaypointGraph.h"
+#include "Objects/Waypoint.h"
+#include "Objects/WaypointNode.h"
+#include "Components/LineBatchComponent.h"
+#include "UObject/ConstructorHelpers.h"
+#include "EngineUtils.h"
+#if WITH_EDITOR
+#include "Editor.h"
+#include "Selection.h"
+#endif
+
+
+UWaypointGraphVisualizer::UWaypointGraphVisualizer(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+#if WITH_EDITOR
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> FloorMarker(TEXT("/SimpleWaypoints/SM/Flag.Flag"));
+	if (FloorMarker.Succeeded())
+	{
+		SetStaticMesh(FloorMarker.Object);
+	}
+#endif
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetGenerateOverlapEvents(false);
+	SetCanEverAffectNavigation(false);
+	bHiddenInGame = true;
+	bIsEditorOnly = true;
+	bHasPerInstanceHitProxies = true;
+
+	// Ticks only to apply pending rebuilds
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	bTickInEditor = true;
+}
+
+void UWaypointGraphVisualizer::MarkVisualizationDirty()
+{
+	// Hidden in game, play doesn't need to pay for rebuilds
+	const UWorld* World = GetWorld();
+	if (IsRegistered() && World && !World->IsGameWorld())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UWaypointGraphVisualizer::RebuildVisualization()
+{
+	SetComponentTickEnabled(false);
+
+	const AWaypointGraph* Graph = Cast<AWaypointGraph>(GetOwner());
+	if (!Graph)
+	{
+		return;
+	}
+
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(Graph->GetNumPoints());
+	InstanceWaypoints.Reset(Graph->GetNumPoints());
+	for (AWaypoint* Waypoint : Graph->Waypoints)
+	{
+		if (Waypoint)
+		{
+			Transforms.Add(Waypoint->GetActorTransform());
+			InstanceWaypoints.Add(Waypoint);
+		}
+	}
+	for (const FWaypointNode& Node : Graph->Nodes)
+	{
+		Transforms.Add(FTransform(Graph->GetActorTransform().TransformPosition(Node.Location)));
+		InstanceWaypoints.Add(nullptr);
+	}
+
+	ClearInstances();
+	AddInstances(Transforms, false, /*bWorldSpace*/ true);
+	SetWaypointMeshesVisible(!bHideWaypointMeshes);
+
+	if (!DestinationLines)
+	{
+		return;
+	}
+
+	DestinationLines->Flush();
+
+	// Destinations of selected waypoints are drawn on top
+	bool bGraphSelected = false;
+#if WITH_EDITOR
+	GetSelection(bDrawnGraphSelected, DrawnWaypoints);
+	bGraphSelected = bDrawnGraphSelected;
+#endif
+	TArray<FBatchedLine> Lines;
+	for (const AWaypoint* Waypoint : Graph->Waypoints)
+	{
+		if (Waypoint)
+		{
+			bool bSelected = bGraphSelected;
+#if WITH_EDITOR
+			bSelected |= Waypoint->IsSelected();
+#endif
+			if (bSelected || bDrawDestinations)
+			{
+				AddWaypointArrows(Lines, *Waypoint, bSelected ? SDPG_Foreground : SDPG_World);
+			}
+		}
+	}
+	if (bGraphSelected || bDrawDestinations)
+	{
+		for (const FWaypointNode& Node : Graph->Nodes)
+		{
+			AddNodeArrows(Lines, *Graph, Node, bGraphSelected ? SDPG_Foreground : SDPG_World);
+		}
+	}
+	DestinationLines->DrawLines(Lines);
+}
+
+void UWaypointGraphVisualizer::OnRegister()
+{
+	Super::OnRegister();
+
+	if (!DestinationLines && GetOwner())
+	{
+		DestinationLines = NewObject<ULineBatchComponent>(GetOwner(), NAME_None, RF_Transient | RF_TextExportTransient);
+		DestinationLines->bIsEditorOnly = true;
+		DestinationLines->SetHiddenInGame(true);
+		DestinationLines->SetupAttachment(this);
+		DestinationLines->RegisterComponent();
+	}
+#if WITH_EDITOR
+	if (!SelectionChangedHandle.IsValid())
+	{
+		SelectionChangedHandle = USelection::SelectionChangedEvent.AddUObject(this, &UWaypointGraphVisualizer::OnSelectionChanged);
+	}
+#endif
+	MarkVisualizationDirty();
+}
+
+void UWaypointGraphVisualizer::OnUnregister()
+{
+#if WITH_EDITOR
+	USelection::SelectionChangedEvent.Remove(SelectionChangedHandle);
+	SelectionChangedHandle.Reset();
+#endif
+	if (DestinationLines)
+	{
+		DestinationLines->DestroyComponent();
+		DestinationLines = nullptr;
+	}
+	SetWaypointMeshesVisible(true);
+
+	Super::OnUnregister();
+}
+
+void UWaypointGraphVisualizer::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	RebuildVisualization();
+}
+
+void UWaypointGraphVisualizer::CreateHitProxyData(TArray<TRefCountPtr<HHitProxy>>& HitProxies)
+{
+	// Same as the default per instance proxies, but clicks select actors instead of instances
+	HitProxies.Reset(GetInstanceCount());
+	for (int32 InstanceIndex = 0; InstanceIndex < GetInstanceCount(); ++InstanceIndex)
+	{
+		AWaypoint* Waypoint = InstanceWaypoints.IsValidIndex(InstanceIndex) ? InstanceWaypoints[InstanceIndex].Get() : nullptr;
+		AActor* Actor = Waypoint ? static_cast<AActor*>(Waypoint) : GetOwner();
+		HitProxies.Add(new HActor(Actor, this));
+	}
+}
+
+void UWaypointGraphVisualizer::AddArrow(TArray<FBatchedLine>& Lines, const FVector& Start, const FVector& End, const FLinearColor& Color, float Thickness, uint8 DepthPriority) const
+{
+	// Head shaped like DrawDebugDirectionalArrow's
+	FVector Direction = (End - Start).GetSafeNormal();
+	FVector Up = FVector::UpVector;
+	FVector Right = Direction ^ Up;
+	if (!Right.IsNormalized())
+	{
+		Direction.FindBestAxisVectors(Up, Right);
+	}
+	const FVector::FReal HeadSize = FMath::Sqrt(ArrowSize);
+	const FVector Back = -Direction * HeadSize;
+	const FVector Side = Right * HeadSize;
+
+	Lines.Emplace(Start, End, Color, 0.f, Thickness, DepthPriority);
+	Lines.Emplace(End, End + Back + Side, Color, 0.f, Thickness, DepthPriority);
+	Lines.Emplace(End, End + Back - Side, Color, 0.f, Thickness, DepthPriority);
+}
+
+void UWaypointGraphVisualizer::AddWaypointArrows(TArray<FBatchedLine>& Lines, const AWaypoint& Waypoint, uint8 DepthPriority) const
+{
+	for (const auto& Destination : Waypoint.ViewDestinations())
+	{
+		if (const AWaypoint* DestinationWaypoint = Destination.Key)
+		{
+			const FColor Color = DestinationWaypoint->HasConditions() ? FColor::Blue : (DestinationWaypoint->IsPointEnabled() ? FColor::Green : FColor::Red);
+			AddArrow(Lines, Waypoint.GetActorLocation(), DestinationWaypoint->GetActorLocation(), Color, Destination.Value + 1.f, DepthPriority);
+		}
+	}
+}
+
+void UWaypointGraphVisualizer::AddNodeArrows(TArray<FBatchedLine>& Lines, const AWaypointGraph& Graph, const FWaypointNode& Node, uint8 DepthPriority) const
+{
+	const FTransform& GraphTransform = Graph.GetActorTransform();
+	const FVector From = GraphTransform.TransformPosition(Node.Location);
+	for (const FWaypointNodeDestination& Destination : Node.Destinations)
+	{
+		if (Graph.Nodes.IsValidIndex(Destination.Node))
+		{
+			const FWaypointNode& DestinationNode = Graph.Nodes[Destination.Node];
+			const FColor Color = !DestinationNode.UseConditions.IsEmpty() ? FColor::Blue : (DestinationNode.bIsEnabled ? FColor::Green : FColor::Red);
+			AddArrow(Lines, From, GraphTransform.TransformPosition(DestinationNode.Location), Color, Destination.Weight + 1.f, DepthPriority);
+		}
+	}
+}
+
+void UWaypointGraphVisualizer::SetWaypointMeshesVisible(bool bVisible) const
+{
+	if (const AWaypointGraph* Graph = Cast<AWaypointGraph>(GetOwner()))
+	{
+		for (AWaypoint* Waypoint : Graph->Waypoints)
+		{
+			if (Waypoint)
+			{
+				Waypoint->SetMeshVisible(bVisible);
+			}
+		}
+	}
+}
+
+#if WITH_EDITOR
+void UWaypointGraphVisualizer::GetSelection(bool& bOutGraphSelected, FWaypointSelection& OutWaypoints) const
+{
+	bOutGraphSelected = false;
+	OutWaypoints.Reset();
+
+	const AWaypointGraph* Graph = Cast<AWaypointGraph>(GetOwner());
+	if (!Graph || !GEditor)
+	{
+		return;
+	}
+
+	bOutGraphSelected = Graph->IsSelected();
+	for (FSelectionIterator It(GEditor->GetSelectedActorIterator()); It; ++It)
+	{
+		const AWaypoint* Waypoint = Cast<AWaypoint>(*It);
+		if (Waypoint && Waypoint->GetAttachParentActor() == Graph)
+		{
+			OutWaypoints.Add(Waypoint);
+		}
+	}
+}
+
+void UWaypointGraphVisualizer::OnSelectionChanged(UObject* Selection)
+{
+	// Event is broadcast for every selection change in the editor, most don't concern this graph
+	bool bGraphSelected = false;
+	FWaypointSelection SelectedWaypoints;
+	GetSelection(bGraphSelected, SelectedWaypoints);
+	if (bGraphSelected != bDrawnGraphSelected || SelectedWaypoints != DrawnWaypoints)
+	{
+		MarkVisualizationDirty();
+	}
+}
+#endif
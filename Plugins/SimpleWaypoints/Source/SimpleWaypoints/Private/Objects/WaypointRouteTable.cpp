@@ -0,0 +1,550 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+
+#include "Objects/WaypointRouteTable.h"
+#include "Objects/WaypointCompiledGraph.h"
+#include "Objects/Waypoint.h"
+#include "Objects/WaypointNode.h"
+#include "SimpleWaypointsStats.h"
+#include "Algo/Reverse.h"
+
+static TAutoConsoleVariable<int32> CVarRouteTableMaxNodes(
+	TEXT("SimpleWaypoints.RouteTableMaxNodes"),
+	256,
+	TEXT("Graphs with up to this many waypoints get precomputed next hop tables (memory grows with the square of the count).\n")
+	TEXT("Larger graphs are routed with A* on demand. Clamped to 1024."),
+	ECVF_Default);
+
+/** Keeps the table within int16 and its memory sane */
+static constexpr int32 MaxNextHopTableNodes = 1024;
+
+/** Unreachable distance in the next hop table */
+static constexpr float UnreachableDistance = TNumericLimits<float>::Max();
+
+/**
+*	Per node A* data. Shared by all queries of a thread instead of living in every
+*	FWaypointRouteScratch, grows to the largest graph searched on the thread.
+*/
+struct FWaypointRouteSearch
+{
+	/** Valid only where Stamps match SearchStamp */
+	TArray<float> Costs;
+	TArray<int32> Parents;
+	TArray<uint32> Stamps;
+	uint32 SearchStamp = 0;
+	/** Binary heap, stale entries are skipped when popped */
+	TArray<FWaypointRouteTable::FOpenNode> Open;
+};
+
+static thread_local FWaypointRouteSearch RouteSearch;
+
+
+void FWaypointRouteTable::Build(const FWaypointCompiledGraph& Graph, TConstArrayView<AWaypoint*> Waypoints, TConstArrayView<FWaypointNode> Nodes, const FTransform& NodesTransform)
+{
+	SIMPLEWAYPOINTS_SCOPE(BuildRouteTable);
+
+	Reset();
+	++Version;
+
+	const int32 NumGraphNodes = Graph.NumNodes();
+	if (!ensureMsgf(NumGraphNodes == Waypoints.Num() + Nodes.Num(), TEXT("Route table built from a stale compiled graph")))
+	{
+		return;
+	}
+
+	TArray<float> CostScales;
+	CostScales.SetNumUninitialized(NumGraphNodes);
+	Positions.SetNumUninitialized(NumGraphNodes);
+	EnabledNodes.Init(false, NumGraphNodes);
+	for (int32 Node = 0; Node < Waypoints.Num(); ++Node)
+	{
+		const AWaypoint* Waypoint = Waypoints[Node];
+		Positions[Node] = Waypoint ? FVector3f(Waypoint->GetActorLocation()) : FVector3f::ZeroVector;
+		EnabledNodes[Node] = Waypoint && Waypoint->IsPointEnabled();
+		CostScales[Node] = Waypoint ? FMath::Max(Waypoint->GetRouteCostScale(), 1.f) : 1.f;
+	}
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); ++NodeIndex)
+	{
+		const FWaypointNode& DataNode = Nodes[NodeIndex];
+		const int32 Node = Waypoints.Num() + NodeIndex;
+		Positions[Node] = FVector3f(NodesTransform.TransformPosition(DataNode.Location));
+		EnabledNodes[Node] = DataNode.bIsEnabled;
+		CostScales[Node] = FMath::Max(DataNode.RouteCostScale, 1.f);
+	}
+
+	BuildEdges(Graph.NumEdges(), [&Graph](int32 Node) { return Graph.GetDestinations(Node); }, CostScales);
+}
+
+void FWaypointRouteTable::BuildEdges(int32 NumGraphEdges, TFunctionRef<TConstArrayView<int32>(int32)> GetNodeDestinations, TConstArrayView<float> CostScales)
+{
+	const int32 NumGraphNodes = Positions.Num();
+	Offsets.Reserve(NumGraphNodes + 1);
+	Destinations.Reserve(NumGraphEdges);
+	EdgeLengths.Reserve(NumGraphEdges);
+	for (int32 Node = 0; Node < NumGraphNodes; ++Node)
+	{
+		Offsets.Add(Destinations.Num());
+		for (const int32 Destination : GetNodeDestinations(Node))
+		{
+			Destinations.Add(Destination);
+			EdgeLengths.Add(float(FVector3f::Dist(Positions[Node], Positions[Destination])) * CostScales[Destination]);
+		}
+	}
+	Offsets.Add(Destinations.Num());
+
+	// Incoming edges of every node (CSR as well), used to search from goals and to find routes affected by updates
+	InOffsets.SetNumZeroed(NumGraphNodes + 1);
+	InEdges.SetNumUninitialized(Destinations.Num());
+	for (const int32 Destination : Destinations)
+	{
+		++InOffsets[Destination + 1];
+	}
+	for (int32 Node = 0; Node < NumGraphNodes; ++Node)
+	{
+		InOffsets[Node + 1] += InOffsets[Node];
+	}
+	TArray<int32> InFill(InOffsets.GetData(), NumGraphNodes);
+	for (int32 Source = 0; Source < NumGraphNodes; ++Source)
+	{
+		for (int32 Edge = Offsets[Source]; Edge < Offsets[Source + 1]; ++Edge)
+		{
+			InEdges[InFill[Destinations[Edge]]++] = { Source, Edge };
+		}
+	}
+
+	if (NumGraphNodes <= FMath::Min(CVarRouteTableMaxNodes.GetValueOnAnyThread(), MaxNextHopTableNodes))
+	{
+		BuildNextHopTable();
+	}
+}
+
+void FWaypointRouteTable::Reset()
+{
+	Offsets.Reset();
+	Destinations.Reset();
+	EdgeLengths.Reset();
+	InOffsets.Reset();
+	InEdges.Reset();
+	Positions.Reset();
+	EnabledNodes.Reset();
+	NextHops.Reset();
+	Distances.Reset();
+}
+
+void FWaypointRouteTable::BuildNextHopTable()
+{
+	const int32 N = NumNodes();
+	NextHops.SetNumUninitialized(N * N);
+	Distances.SetNumUninitialized(N * N);
+
+	// Searching from the goal over incoming edges gives routes of all nodes at once
+	for (int32 Goal = 0; Goal < N; ++Goal)
+	{
+		if (EnabledNodes[Goal])
+		{
+			BuildRow(Goal);
+		}
+		else
+		{
+			ClearRow(Goal);
+		}
+	}
+}
+
+void FWaypointRouteTable::BuildRow(int32 Goal)
+{
+	ClearRow(Goal);
+
+	const int32 N = NumNodes();
+	NextHops[Goal * N + Goal] = int16(Goal);
+	Distances[Goal * N + Goal] = 0.f;
+
+	RowOpen.Reset();
+	RowOpen.HeapPush({ 0.f, 0.f, Goal });
+	RelaxRow(Goal);
+}
+
+void FWaypointRouteTable::ClearRow(int32 Goal)
+{
+	const int32 N = NumNodes();
+	for (int32 Node = 0; Node < N; ++Node)
+	{
+		NextHops[Goal * N + Node] = INDEX_NONE;
+		Distances[Goal * N + Node] = UnreachableDistance;
+	}
+}
+
+void FWaypointRouteTable::RepairRow(int32 Goal, TConstArrayView<int32> Roots)
+{
+	const int32 N = NumNodes();
+	int16* GoalHops = &NextHops[Goal * N];
+	float* GoalDistances = &Distances[Goal * N];
+
+	// Nodes routed through the roots lost their routes too, they are subtrees of the shortest path tree
+	RowAffected.Reset();
+	RowAffectedMask.Init(false, N);
+	for (const int32 Root : Roots)
+	{
+		if (!RowAffectedMask[Root])
+		{
+			RowAffectedMask[Root] = true;
+			RowAffected.Add(Root);
+		}
+	}
+	for (int32 i = 0; i < RowAffected.Num(); ++i)
+	{
+		const int32 Node = RowAffected[i];
+		for (int32 In = InOffsets[Node]; In < InOffsets[Node + 1]; ++In)
+		{
+			const int32 Source = InEdges[In].Source;
+			if (Source != Goal && GoalHops[Source] == Node && !RowAffectedMask[Source])
+			{
+				RowAffectedMask[Source] = true;
+				RowAffected.Add(Source);
+			}
+		}
+	}
+
+	for (const int32 Node : RowAffected)
+	{
+		GoalHops[Node] = INDEX_NONE;
+		GoalDistances[Node] = UnreachableDistance;
+	}
+
+	// Reattach affected nodes to the intact routes, then settle them among themselves
+	RowOpen.Reset();
+	for (const int32 Node : RowAffected)
+	{
+		for (int32 Edge = Offsets[Node]; Edge < Offsets[Node + 1]; ++Edge)
+		{
+			const int32 Next = Destinations[Edge];
+			if (RowAffectedMask[Next] || !CanEnter(Next, Goal) || GoalDistances[Next] == UnreachableDistance)
+			{
+				continue;
+			}
+
+			const float NewCost = GoalDistances[Next] + EdgeLengths[Edge];
+			if (NewCost < GoalDistances[Node])
+			{
+				GoalDistances[Node] = NewCost;
+				GoalHops[Node] = int16(Next);
+			}
+		}
+
+		if (GoalDistances[Node] != UnreachableDistance)
+		{
+			RowOpen.HeapPush({ GoalDistances[Node], GoalDistances[Node], Node });
+		}
+	}
+	RelaxRow(Goal);
+}
+
+void FWaypointRouteTable::RelaxRow(int32 Goal)
+{
+	const int32 N = NumNodes();
+	int16* GoalHops = &NextHops[Goal * N];
+	float* GoalDistances = &Distances[Goal * N];
+
+	while (!RowOpen.IsEmpty())
+	{
+		FOpenNode Top;
+		RowOpen.HeapPop(Top, EAllowShrinking::No);
+		if (Top.Cost > GoalDistances[Top.Node])
+		{
+			continue;
+		}
+		// Disabled node keeps its own route out, but nobody routes through it
+		if (!CanEnter(Top.Node, Goal))
+		{
+			continue;
+		}
+
+		for (int32 In = InOffsets[Top.Node]; In < InOffsets[Top.Node + 1]; ++In)
+		{
+			const FIncomingEdge& Incoming = InEdges[In];
+			const float NewCost = Top.Cost + EdgeLengths[Incoming.Edge];
+			if (NewCost < GoalDistances[Incoming.Source])
+			{
+				GoalDistances[Incoming.Source] = NewCost;
+				GoalHops[Incoming.Source] = int16(Top.Node);
+				RowOpen.HeapPush({ NewCost, NewCost, Incoming.Source });
+			}
+		}
+	}
+}
+
+void FWaypointRouteTable::SetNodeEnabled(int32 Node, bool bEnabled)
+{
+	if (!IsValidNode(Node) || EnabledNodes[Node] == bEnabled)
+	{
+		return;
+	}
+
+	SIMPLEWAYPOINTS_SCOPE(RepairRouteTable);
+
+	EnabledNodes[Node] = bEnabled;
+	++Version;
+
+	// A* reads the flags on every search
+	if (!HasNextHopTable())
+	{
+		return;
+	}
+
+	const int32 N = NumNodes();
+	if (bEnabled)
+	{
+		BuildRow(Node);
+		for (int32 Goal = 0; Goal < N; ++Goal)
+		{
+			// Node already had its own routes, others can only get shorter by passing through it
+			const float NodeDistance = Distances[Goal * N + Node];
+			if (Goal != Node && EnabledNodes[Goal] && NodeDistance != UnreachableDistance)
+			{
+				RowOpen.Reset();
+				RowOpen.HeapPush({ NodeDistance, NodeDistance, Node });
+				RelaxRow(Goal);
+			}
+		}
+	}
+	else
+	{
+		ClearRow(Node);
+		for (int32 Goal = 0; Goal < N; ++Goal)
+		{
+			if (Goal == Node || !EnabledNodes[Goal])
+			{
+				continue;
+			}
+
+			RowRoots.Reset();
+			for (int32 In = InOffsets[Node]; In < InOffsets[Node + 1]; ++In)
+			{
+				const int32 Source = InEdges[In].Source;
+				if (Source != Goal && NextHops[Goal * N + Source] == Node)
+				{
+					RowRoots.Add(Source);
+				}
+			}
+			if (!RowRoots.IsEmpty())
+			{
+				RepairRow(Goal, RowRoots);
+			}
+		}
+	}
+}
+
+void FWaypointRouteTable::SetNodeCostScale(int32 Node, float CostScale)
+{
+	if (!IsValidNode(Node))
+	{
+		return;
+	}
+
+	SIMPLEWAYPOINTS_SCOPE(RepairRouteTable);
+
+	CostScale = FMath::Max(CostScale, 1.f);
+	for (int32 In = InOffsets[Node]; In < InOffsets[Node + 1]; ++In)
+	{
+		const FIncomingEdge& Incoming = InEdges[In];
+		SetEdgeCost(Incoming.Source, Node, Incoming.Edge, float(FVector3f::Dist(Positions[Incoming.Source], Positions[Node])) * CostScale);
+	}
+}
+
+void FWaypointRouteTable::SetEdgeCost(int32 Source, int32 Destination, int32 Edge, float NewCost)
+{
+	const float OldCost = EdgeLengths[Edge];
+	if (OldCost == NewCost)
+	{
+		return;
+	}
+
+	EdgeLengths[Edge] = NewCost;
+	++Version;
+
+	if (!HasNextHopTable())
+	{
+		return;
+	}
+
+	const int32 N = NumNodes();
+	for (int32 Goal = 0; Goal < N; ++Goal)
+	{
+		if (!EnabledNodes[Goal] || Source == Goal)
+		{
+			continue;
+		}
+
+		int16* GoalHops = &NextHops[Goal * N];
+		float* GoalDistances = &Distances[Goal * N];
+		if (NewCost > OldCost)
+		{
+			// Only routes using the edge can get longer
+			if (GoalHops[Source] == Destination)
+			{
+				RowRoots.Reset();
+				RowRoots.Add(Source);
+				RepairRow(Goal, RowRoots);
+			}
+		}
+		else if (CanEnter(Destination, Goal) && GoalDistances[Destination] != UnreachableDistance)
+		{
+			const float NewDistance = GoalDistances[Destination] + NewCost;
+			if (NewDistance < GoalDistances[Source])
+			{
+				GoalDistances[Source] = NewDistance;
+				GoalHops[Source] = int16(Destination);
+				RowOpen.Reset();
+				RowOpen.HeapPush({ NewDistance, NewDistance, Source });
+				RelaxRow(Goal);
+			}
+		}
+	}
+}
+
+int32 FWaypointRouteTable::GetNextHop(int32 From, int32 Goal, FWaypointRouteScratch& Scratch) const
+{
+	if (!IsValidNode(From) || !IsValidNode(Goal))
+	{
+		return INDEX_NONE;
+	}
+	if (From == Goal)
+	{
+		return Goal;
+	}
+	if (HasNextHopTable())
+	{
+		return NextHops[Goal * NumNodes() + From];
+	}
+
+	const int32 PathIndex = FindInPath(From, Goal, Scratch);
+	return Scratch.bPathFound ? Scratch.Path[PathIndex + 1] : INDEX_NONE;
+}
+
+float FWaypointRouteTable::GetRouteDistance(int32 From, int32 Goal, FWaypointRouteScratch& Scratch) const
+{
+	if (!IsValidNode(From) || !IsValidNode(Goal))
+	{
+		return -1.f;
+	}
+	if (From == Goal)
+	{
+		return 0.f;
+	}
+	if (HasNextHopTable())
+	{
+		const float Distance = Distances[Goal * NumNodes() + From];
+		return Distance == UnreachableDistance ? -1.f : Distance;
+	}
+
+	const int32 PathIndex = FindInPath(From, Goal, Scratch);
+	return Scratch.bPathFound ? Scratch.PathCosts.Last() - Scratch.PathCosts[PathIndex] : -1.f;
+}
+
+int32 FWaypointRouteTable::FindInPath(int32 From, int32 Goal, FWaypointRouteScratch& Scratch) const
+{
+	if (Scratch.PathVersion == Version && Scratch.PathGoal == Goal)
+	{
+		// Route is walked forward, so the next query is usually right after the last one
+		for (int32 i = Scratch.PathCursor; i < Scratch.Path.Num(); ++i)
+		{
+			if (Scratch.Path[i] == From)
+			{
+				Scratch.PathCursor = i;
+				return i;
+			}
+		}
+	}
+
+	FindPath(From, Goal, Scratch);
+	return 0;
+}
+
+void FWaypointRouteTable::FindPath(int32 From, int32 Goal, FWaypointRouteScratch& Scratch) const
+{
+	SIMPLEWAYPOINTS_SCOPE(FindWaypointRoute);
+
+	const int32 N = NumNodes();
+	Scratch.Path.Reset();
+	Scratch.PathCosts.Reset();
+	Scratch.Path.Add(From);
+	Scratch.PathCosts.Add(0.f);
+	Scratch.PathCursor = 0;
+	Scratch.PathGoal = Goal;
+	Scratch.PathVersion = Version;
+	Scratch.bPathFound = false;
+
+	if (!EnabledNodes[Goal])
+	{
+		return;
+	}
+
+	FWaypointRouteSearch& Search = RouteSearch;
+	if (Search.Stamps.Num() < N)
+	{
+		Search.Costs.SetNumUninitialized(N);
+		Search.Parents.SetNumUninitialized(N);
+		Search.Stamps.SetNumZeroed(N);
+	}
+	if (++Search.SearchStamp == 0)
+	{
+		FMemory::Memzero(Search.Stamps.GetData(), Search.Stamps.Num() * sizeof(uint32));
+		Search.SearchStamp = 1;
+	}
+	const uint32 Stamp = Search.SearchStamp;
+
+	Search.Stamps[From] = Stamp;
+	Search.Costs[From] = 0.f;
+	Search.Parents[From] = INDEX_NONE;
+	Search.Open.Reset();
+	Search.Open.HeapPush({ GetHeuristic(From, Goal), 0.f, From });
+
+	while (!Search.Open.IsEmpty())
+	{
+		FOpenNode Top;
+		Search.Open.HeapPop(Top, EAllowShrinking::No);
+		if (Top.Cost > Search.Costs[Top.Node])
+		{
+			continue;
+		}
+		if (Top.Node == Goal)
+		{
+			Scratch.bPathFound = true;
+			break;
+		}
+
+		for (int32 Edge = Offsets[Top.Node]; Edge < Offsets[Top.Node + 1]; ++Edge)
+		{
+			const int32 Next = Destinations[Edge];
+			if (!EnabledNodes[Next])
+			{
+				continue;
+			}
+
+			const float NewCost = Top.Cost + EdgeLengths[Edge];
+			if (Search.Stamps[Next] != Stamp || NewCost < Search.Costs[Next])
+			{
+				Search.Stamps[Next] = Stamp;
+				Search.Costs[Next] = NewCost;
+				Search.Parents[Next] = Top.Node;
+				Search.Open.HeapPush({ NewCost + GetHeuristic(Next, Goal), NewCost, Next });
+			}
+		}
+	}
+
+	if (!Scratch.bPathFound)
+	{
+		return;
+	}
+
+	// Walk parents back from the goal, then flip the route
+	Scratch.Path.Reset();
+	Scratch.PathCosts.Reset();
+	for (int32 Node = Goal; Node != INDEX_NONE; Node = Search.Parents[Node])
+	{
+		Scratch.Path.Add(Node);
+		Scratch.PathCosts.Add(Search.Costs[Node]);
+	}
+	Algo::Reverse(Scratch.Path);
+	Algo::Reverse(Scratch.PathCosts);
+}
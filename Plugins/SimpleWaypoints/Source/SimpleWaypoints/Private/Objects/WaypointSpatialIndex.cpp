@@ -0,0 +1,187 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+
+#include "Objects/WaypointSpatialIndex.h"
+
+
+void FWaypointSpatialIndex::Build(TConstArrayView<FVector> InLocations)
+{
+	Locations.Reset(InLocations.Num());
+	Locations.Append(InLocations.GetData(), InLocations.Num());
+	Nodes.SetNum(Locations.Num());
+	for (int32 i = 0; i < Locations.Num(); ++i)
+	{
+		Nodes[i].PointIndex = i;
+	}
+
+	BuildRecursive(0, Nodes.Num());
+}
+
+void FWaypointSpatialIndex::Reset()
+{
+	Locations.Reset();
+	Nodes.Reset();
+}
+
+int32 FWaypointSpatialIndex::FindNearest(const FVector& ToLocation) const
+{
+	int32 BestIndex = INDEX_NONE;
+	double BestDistSq = TNumericLimits<double>::Max();
+	FindNearestRecursive(0, Nodes.Num(), ToLocation, BestIndex, BestDistSq);
+	return BestIndex;
+}
+
+int32 FWaypointSpatialIndex::FindFarthest(const FVector& ToLocation) const
+{
+	int32 BestIndex = INDEX_NONE;
+	double BestDistSq = -1.0;
+	FindFarthestRecursive(0, Nodes.Num(), ToLocation, BestIndex, BestDistSq);
+	return BestIndex;
+}
+
+int32 FWaypointSpatialIndex::FindKNearest(const FVector& ToLocation, TArrayView<int32> OutIndices) const
+{
+	int32 Count = 0;
+	if (!OutIndices.IsEmpty())
+	{
+		FindKNearestRecursive(0, Nodes.Num(), ToLocation, OutIndices, Count);
+	}
+	return Count;
+}
+
+void FWaypointSpatialIndex::BuildRecursive(int32 Begin, int32 End)
+{
+	if (Begin >= End)
+	{
+		return;
+	}
+
+	FBox Bounds(ForceInit);
+	for (int32 i = Begin; i < End; ++i)
+	{
+		Bounds += Locations[Nodes[i].PointIndex];
+	}
+
+	// Split along the longest extent to keep the cells close to cubes
+	const FVector Extent = Bounds.GetSize();
+	const uint8 Axis = Extent.X >= Extent.Y ? (Extent.X >= Extent.Z ? 0 : 2) : (Extent.Y >= Extent.Z ? 1 : 2);
+
+	TArrayView<FNode> Range = MakeArrayView(Nodes).Slice(Begin, End - Begin);
+	Range.Sort([this, Axis](const FNode& A, const FNode& B)
+		{
+			return Locations[A.PointIndex][Axis] < Locations[B.PointIndex][Axis];
+		});
+
+	const int32 Mid = Begin + (End - Begin) / 2;
+	Nodes[Mid].Bounds = Bounds;
+	Nodes[Mid].Axis = Axis;
+
+	BuildRecursive(Begin, Mid);
+	BuildRecursive(Mid + 1, End);
+}
+
+void FWaypointSpatialIndex::FindNearestRecursive(int32 Begin, int32 End, const FVector& ToLocation, int32& BestIndex, double& BestDistSq) const
+{
+	if (Begin >= End)
+	{
+		return;
+	}
+
+	const int32 Mid = Begin + (End - Begin) / 2;
+	const FNode& Node = Nodes[Mid];
+	const FVector& Location = Locations[Node.PointIndex];
+
+	const double DistSq = FVector::DistSquared(Location, ToLocation);
+	if (DistSq < BestDistSq)
+	{
+		BestDistSq = DistSq;
+		BestIndex = Node.PointIndex;
+	}
+
+	const double Delta = ToLocation[Node.Axis] - Location[Node.Axis];
+	const bool bLeftFirst = Delta < 0.0;
+
+	// Near side first, far side only if the splitting plane is closer than the best match
+	FindNearestRecursive(bLeftFirst ? Begin : Mid + 1, bLeftFirst ? Mid : End, ToLocation, BestIndex, BestDistSq);
+	if (Delta * Delta < BestDistSq)
+	{
+		FindNearestRecursive(bLeftFirst ? Mid + 1 : Begin, bLeftFirst ? End : Mid, ToLocation, BestIndex, BestDistSq);
+	}
+}
+
+void FWaypointSpatialIndex::FindFarthestRecursive(int32 Begin, int32 End, const FVector& ToLocation, int32& BestIndex, double& BestDistSq) const
+{
+	if (Begin >= End)
+	{
+		return;
+	}
+
+	const int32 Mid = Begin + (End - Begin) / 2;
+	const FNode& Node = Nodes[Mid];
+
+	// Nothing in this subtree can beat the current candidate
+	if (GetMaxDistSquared(Node.Bounds, ToLocation) <= BestDistSq)
+	{
+		return;
+	}
+
+	const double DistSq = FVector::DistSquared(Locations[Node.PointIndex], ToLocation);
+	if (DistSq > BestDistSq)
+	{
+		BestDistSq = DistSq;
+		BestIndex = Node.PointIndex;
+	}
+
+	// Far side first, it is more likely to contain the answer
+	const bool bLeftFirst = ToLocation[Node.Axis] >= Locations[Node.PointIndex][Node.Axis];
+	FindFarthestRecursive(bLeftFirst ? Begin : Mid + 1, bLeftFirst ? Mid : End, ToLocation, BestIndex, BestDistSq);
+	FindFarthestRecursive(bLeftFirst ? Mid + 1 : Begin, bLeftFirst ? End : Mid, ToLocation, BestIndex, BestDistSq);
+}
+
+void FWaypointSpatialIndex::FindKNearestRecursive(int32 Begin, int32 End, const FVector& ToLocation, TArrayView<int32> OutIndices, int32& OutCount) const
+{
+	if (Begin >= End)
+	{
+		return;
+	}
+
+	const int32 Mid = Begin + (End - Begin) / 2;
+	const FNode& Node = Nodes[Mid];
+	const FVector& Location = Locations[Node.PointIndex];
+	const int32 Capacity = OutIndices.Num();
+
+	auto GetWorstDistSq = [&]()
+		{
+			return OutCount < Capacity ? TNumericLimits<double>::Max() : FVector::DistSquared(Locations[OutIndices[OutCount - 1]], ToLocation);
+		};
+
+	// Insertion into the sorted output, dropping the worst entry if full
+	const double DistSq = FVector::DistSquared(Location, ToLocation);
+	if (DistSq < GetWorstDistSq())
+	{
+		int32 Slot = FMath::Min(OutCount, Capacity - 1);
+		while (Slot > 0 && FVector::DistSquared(Locations[OutIndices[Slot - 1]], ToLocation) > DistSq)
+		{
+			OutIndices[Slot] = OutIndices[Slot - 1];
+			--Slot;
+		}
+		OutIndices[Slot] = Node.PointIndex;
+		OutCount = FMath::Min(OutCount + 1, Capacity);
+	}
+
+	const double Delta = ToLocation[Node.Axis] - Location[Node.Axis];
+	const bool bLeftFirst = Delta < 0.0;
+
+	FindKNearestRecursive(bLeftFirst ? Begin : Mid + 1, bLeftFirst ? Mid : End, ToLocation, OutIndices, OutCount);
+	if (Delta * Delta < GetWorstDistSq())
+	{
+		FindKNearestRecursive(bLeftFirst ? Mid + 1 : Begin, bLeftFirst ? End : Mid, ToLocation, OutIndices, OutCount);
+	}
+}
+
+double FWaypointSpatialIndex::GetMaxDistSquared(const FBox& Box, const FVector& ToLocation)
+{
+	const FVector ToMin = (ToLocation - Box.Min).GetAbs();
+	const FVector ToMax = (ToLocation - Box.Max).GetAbs();
+	return FVector::Max(ToMin, ToMax).SizeSquared();
+}
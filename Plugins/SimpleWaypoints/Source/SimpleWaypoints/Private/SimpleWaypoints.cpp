@@ -1,6 +1,29 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "SimpleWaypoints.h"
+#include "SimpleWaypointsStats.h"
+
+DEFINE_STAT(STAT_SelectWaypoint);
+DEFINE_STAT(STAT_FilterDestinations);
+DEFINE_STAT(STAT_CheckConditions);
+DEFINE_STAT(STAT_GetNearestPoint);
+DEFINE_STAT(STAT_SetWaypointBehaviorParameters);
+DEFINE_STAT(STAT_BuildRouteTable);
+DEFINE_STAT(STAT_FindWaypointRoute);
+DEFINE_STAT(STAT_RepairRouteTable);
+DEFINE_STAT(STAT_FindWaypointPath);
+
+DEFINE_STAT(STAT_WaypointSelections);
+DEFINE_STAT(STAT_WaypointRejectedCooldown);
+DEFINE_STAT(STAT_WaypointRejectedOccupied);
+DEFINE_STAT(STAT_WaypointRejectedConditions);
+DEFINE_STAT(STAT_WaypointRejectedPending);
+DEFINE_STAT(STAT_WaypointRejectedVisited);
+DEFINE_STAT(STAT_WaypointCooldownEntries);
+DEFINE_STAT(STAT_WaypointConditionCacheHits);
+DEFINE_STAT(STAT_WaypointPathCacheHits);
+
+UE_TRACE_CHANNEL_DEFINE(SimpleWaypointsChannel);
 
 #define LOCTEXT_NAMESPACE "FSimpleWaypointsModule"
 
@@ -0,0 +1,127 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+
+#include "Subsystems/WaypointPathCacheSubsystem.h"
+#include "Objects/Waypoint.h"
+#include "AIController.h"
+#include "NavigationSystem.h"
+#include "NavFilters/NavigationQueryFilter.h"
+#include "HAL/IConsoleManager.h"
+#include "SimpleWaypointsStats.h"
+
+static TAutoConsoleVariable<int32> CVarPathCacheMaxEntries(
+	TEXT("SimpleWaypoints.PathCacheMaxEntries"),
+	4096,
+	TEXT("Max number of navigation paths cached by UWaypointPathCacheSubsystem. Least recently used paths are evicted above it."),
+	ECVF_Default);
+
+
+namespace WaypointPathCache
+{
+	/** Invalidated path is still usable while it waits for recalculation */
+	static bool IsUsable(const FNavigationPath& Path)
+	{
+		return Path.IsValid() || Path.IsWaitingForRepath();
+	}
+}
+
+FNavPathSharedPtr UWaypointPathCacheSubsystem::FindPath(const AAIController& Controller, const AWaypoint& Source, const AWaypoint& Destination, TSubclassOf<UNavigationQueryFilter> FilterClass)
+{
+	SIMPLEWAYPOINTS_SCOPE(FindWaypointPath);
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	const ANavigationData* NavData = NavSys ? NavSys->GetNavDataForProps(Controller.GetNavAgentPropertiesRef(), Controller.GetNavAgentLocation()) : nullptr;
+	if (!NavData)
+	{
+		return nullptr;
+	}
+
+	const FPathKey Key{ &Source, &Destination, NavData, FilterClass.Get() };
+	if (FCachedPath* CachedPath = Paths.Find(Key))
+	{
+		if (WaypointPathCache::IsUsable(*CachedPath->Path))
+		{
+			INC_DWORD_STAT(STAT_WaypointPathCacheHits);
+			CachedPath->LastUsedFrame = GFrameCounter;
+			return CachedPath->Path;
+		}
+		Paths.Remove(Key);
+	}
+
+	// Path is shared by every agent on the edge, so neither it nor its filter is tied to the querier and only full paths are kept
+	FPathFindingQuery Query(nullptr, *NavData, Source.GetActorLocation(), Destination.GetActorLocation(), UNavigationQueryFilter::GetQueryFilter(*NavData, nullptr, FilterClass));
+	Query.SetNavAgentProperties(Controller.GetNavAgentPropertiesRef());
+	Query.SetAllowPartialPaths(false);
+
+	const FPathFindingResult Result = NavSys->FindPathSync(Query);
+	if (!Result.IsSuccessful() || !Result.Path.IsValid())
+	{
+		return nullptr;
+	}
+
+	// Navigation data registered the path when creating it, tile rebuilds will recalculate it
+	Result.Path->EnableRecalculationOnInvalidation(true);
+
+	if (Paths.Num() >= CVarPathCacheMaxEntries.GetValueOnGameThread())
+	{
+		PrunePaths();
+		EvictPaths(1);
+	}
+	if (Paths.Num() < CVarPathCacheMaxEntries.GetValueOnGameThread())
+	{
+		Paths.Add(Key, { Result.Path, GFrameCounter });
+	}
+	return Result.Path;
+}
+
+bool UWaypointPathCacheSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UWaypointPathCacheSubsystem::PrunePaths()
+{
+	for (auto It = Paths.CreateIterator(); It; ++It)
+	{
+		const FPathKey& Key = It->Key;
+		if (!WaypointPathCache::IsUsable(*It->Value.Path) || !Key.Source.ResolveObjectPtr() || !Key.Destination.ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UWaypointPathCacheSubsystem::EvictPaths(int32 NumToAdd)
+{
+	const int32 MaxEntries = FMath::Max(CVarPathCacheMaxEntries.GetValueOnGameThread(), 0);
+	if (Paths.Num() + NumToAdd <= MaxEntries)
+	{
+		return;
+	}
+
+	// Evict a quarter of the cache at once, so a full cache doesn't sort on every new path
+	const int32 NumToEvict = FMath::Min(Paths.Num(), FMath::Max(Paths.Num() + NumToAdd - MaxEntries, MaxEntries / 4));
+	if (NumToEvict <= 0)
+	{
+		return;
+	}
+
+	TArray<uint64> UsedFrames;
+	UsedFrames.Reserve(Paths.Num());
+	for (const TPair<FPathKey, FCachedPath>& Pair : Paths)
+	{
+		UsedFrames.Add(Pair.Value.LastUsedFrame);
+	}
+	UsedFrames.Sort();
+	const uint64 LastEvictedFrame = UsedFrames[NumToEvict - 1];
+
+	int32 NumEvicted = 0;
+	for (auto It = Paths.CreateIterator(); It && NumEvicted < NumToEvict; ++It)
+	{
+		if (It->Value.LastUsedFrame <= LastEvictedFrame)
+		{
+			It.RemoveCurrent();
+			NumEvicted++;
+		}
+	}
+}
@@ -0,0 +1,234 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+
+#include "Subsystems/WaypointSelectionSubsystem.h"
+#include "Objects/WaypointFollower.h"
+#include "Objects/Waypoint.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
+
+static TAutoConsoleVariable<float> CVarSelectionBudgetMs(
+	TEXT("SimpleWaypoints.SelectionBudgetMs"),
+	0.5f,
+	TEXT("Time in milliseconds UWaypointSelectionSubsystem may spend on resolving queued selections per frame.\n")
+	TEXT("At least one request is always resolved. <= 0 resolves the whole queue."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarParallelSelection(
+	TEXT("SimpleWaypoints.ParallelSelection"),
+	false,
+	TEXT("If true, queued selections are resolved in batches: cooldown, occupancy and history checks run in parallel,\n")
+	TEXT("conditions and occupancy claims are applied on game thread in request order."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSelectionBatchSize(
+	TEXT("SimpleWaypoints.SelectionBatchSize"),
+	64,
+	TEXT("Number of selections gathered for a single parallel batch. The budget is checked between batches."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMaxConditionWaitFrames(
+	TEXT("SimpleWaypoints.MaxConditionWaitFrames"),
+	30,
+	TEXT("How many frames a queued selection may wait for async conditions before pending ones are treated as not met."),
+	ECVF_Default);
+
+
+void UWaypointSelectionSubsystem::RequestSelection(UWaypointFollower* Follower, FOnWaypointSelected Callback)
+{
+	if (!Follower)
+	{
+		return;
+	}
+
+	if (PendingFollowers.Contains(Follower))
+	{
+		FSelectionRequest* Request = PendingRequests.FindByPredicate([Follower](const FSelectionRequest& Request)
+			{
+				return Request.Follower.Get() == Follower;
+			});
+		if (ensure(Request))
+		{
+			Request->Callback = MoveTemp(Callback);
+			return;
+		}
+	}
+
+	PendingFollowers.Add(Follower);
+	PendingRequests.Add({ Follower, MoveTemp(Callback) });
+}
+
+void UWaypointSelectionSubsystem::CancelSelection(UWaypointFollower* Follower)
+{
+	if (PendingFollowers.Remove(Follower) > 0)
+	{
+		// May be called from a callback while the queue is being processed, so the entry is only emptied
+		// and skipped like processed ones. Queue is compacted after processing
+		for (FSelectionRequest& Request : PendingRequests)
+		{
+			if (Request.Follower.Get() == Follower)
+			{
+				Request.Follower.Reset();
+				Request.Callback.Unbind();
+			}
+		}
+	}
+}
+
+void UWaypointSelectionSubsystem::RequeueRequest(UWaypointFollower* Follower, FOnWaypointSelected&& Callback, int32 NumWaits)
+{
+	// Requested again by some callback in the meantime, the newer request supersedes the waiting one
+	if (PendingFollowers.Contains(Follower))
+	{
+		return;
+	}
+
+	PendingFollowers.Add(Follower);
+	PendingRequests.Add({ Follower, MoveTemp(Callback), NumWaits });
+}
+
+void UWaypointSelectionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!PendingRequests.IsEmpty())
+	{
+		if (CVarParallelSelection.GetValueOnGameThread())
+		{
+			ProcessRequestsParallel();
+		}
+		else
+		{
+			ProcessRequests();
+		}
+	}
+}
+
+TStatId UWaypointSelectionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWaypointSelectionSubsystem, STATGROUP_Tickables);
+}
+
+bool UWaypointSelectionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UWaypointSelectionSubsystem::ProcessRequests()
+{
+	const double BudgetSeconds = CVarSelectionBudgetMs.GetValueOnGameThread() * 0.001;
+	const int32 MaxWaits = CVarMaxConditionWaitFrames.GetValueOnGameThread();
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Requests queued by callbacks wait for the next frame
+	const int32 NumQueued = PendingRequests.Num();
+	int32 NumProcessed = 0;
+	while (NumProcessed < FMath::Min(NumQueued, PendingRequests.Num()))
+	{
+		// Callbacks may queue or cancel requests, so take the data out and don't hold a reference to the array element
+		FSelectionRequest& Request = PendingRequests[NumProcessed++];
+		UWaypointFollower* Follower = Request.Follower.Get();
+		FOnWaypointSelected Callback = MoveTemp(Request.Callback);
+		const int32 NumWaits = Request.NumWaits;
+		Request.Follower.Reset();
+		PendingFollowers.Remove(Follower);
+
+		if (Follower)
+		{
+			AWaypoint* SelectedWaypoint = nullptr;
+			if (Follower->TrySelectWaypoint(SelectedWaypoint, NumWaits < MaxWaits))
+			{
+				Callback.ExecuteIfBound(SelectedWaypoint);
+			}
+			else
+			{
+				RequeueRequest(Follower, MoveTemp(Callback), NumWaits + 1);
+			}
+		}
+
+		if (BudgetSeconds > 0.0 && FPlatformTime::Seconds() - StartTime >= BudgetSeconds)
+		{
+			break;
+		}
+	}
+
+	PendingRequests.RemoveAt(0, NumProcessed, EAllowShrinking::No);
+}
+
+void UWaypointSelectionSubsystem::ProcessRequestsParallel()
+{
+	const double BudgetSeconds = CVarSelectionBudgetMs.GetValueOnGameThread() * 0.001;
+	const int32 BatchSize = FMath::Max(1, CVarSelectionBatchSize.GetValueOnGameThread());
+	const int32 MaxWaits = CVarMaxConditionWaitFrames.GetValueOnGameThread();
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Requests queued by callbacks wait for the next frame
+	const int32 NumQueued = PendingRequests.Num();
+	int32 NumProcessed = 0;
+	while (NumProcessed < FMath::Min(NumQueued, PendingRequests.Num()))
+	{
+		// Gather. Followers that don't need a new destination are resolved right away
+		BatchSelections.Reset();
+		BatchFollowers.Reset();
+		BatchCallbacks.Reset();
+		BatchWaits.Reset();
+		const int32 BatchEnd = FMath::Min3(NumProcessed + BatchSize, NumQueued, PendingRequests.Num());
+		for (; NumProcessed < BatchEnd; ++NumProcessed)
+		{
+			FSelectionRequest& Request = PendingRequests[NumProcessed];
+			UWaypointFollower* Follower = Request.Follower.Get();
+			FOnWaypointSelected Callback = MoveTemp(Request.Callback);
+			const int32 NumWaits = Request.NumWaits;
+			Request.Follower.Reset();
+			PendingFollowers.Remove(Follower);
+
+			if (!Follower)
+			{
+				continue;
+			}
+
+			FWaypointPendingSelection& Selection = BatchSelections.AddDefaulted_GetRef();
+			if (Follower->BeginSelection(Selection))
+			{
+				BatchFollowers.Add(Follower);
+				BatchCallbacks.Add(MoveTemp(Callback));
+				BatchWaits.Add(NumWaits);
+			}
+			else
+			{
+				AWaypoint* SelectedWaypoint = Selection.Result;
+				BatchSelections.Pop(EAllowShrinking::No);
+				Callback.ExecuteIfBound(SelectedWaypoint);
+			}
+		}
+
+		// Filter. Only reads followers' and waypoints' state, nothing writes to it until the merge
+		ParallelFor(BatchSelections.Num(), [this](int32 Index)
+			{
+				BatchFollowers[Index]->FilterPendingSelection(BatchSelections[Index]);
+			});
+
+		// Merge in request order, so claims are deterministic and MaxUsers can't be exceeded
+		for (int32 i = 0; i < BatchSelections.Num(); ++i)
+		{
+			if (UWaypointFollower* Follower = BatchFollowers[i]; IsValid(Follower))
+			{
+				if (Follower->FinishSelection(BatchSelections[i], BatchWaits[i] < MaxWaits))
+				{
+					BatchCallbacks[i].ExecuteIfBound(BatchSelections[i].Result);
+				}
+				else
+				{
+					RequeueRequest(Follower, MoveTemp(BatchCallbacks[i]), BatchWaits[i] + 1);
+				}
+			}
+		}
+
+		if (BudgetSeconds > 0.0 && FPlatformTime::Seconds() - StartTime >= BudgetSeconds)
+		{
+			break;
+		}
+	}
+
+	PendingRequests.RemoveAt(0, NumProcessed, EAllowShrinking::No);
+}
@@ -6,9 +6,15 @@
 #include "BehaviorTree/Tasks/BTTask_MoveTo.h"
 #include "MoveToWaypoint.generated.h"
 
+class AWaypoint;
+
 /**
  *  This MoveTo puts calls ReachWaypoint in case of success
- *  and puts waypoint on cooldown in case of failure.
+ *  and puts waypoint on cooldown in case of failure, whether the move
+ *  finished right away or later.
+ *
+ *  Moves between neighbouring waypoints reuse navigation paths from
+ *  UWaypointPathCacheSubsystem instead of running pathfinding every time.
  * 
  *	@see UWaypointFollower
  */
@@ -22,4 +28,15 @@ public:
 	
 protected:
 	virtual EBTNodeResult::Type PerformMoveTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	/** Reaches or ignores the waypoint depending on the result */
+	virtual void OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult) override;
+	/** Requests move along a cached path from the last reached waypoint. Returns false if there's no such path and regular MoveTo has to run */
+	bool PerformCachedMove(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, AWaypoint& Destination, EBTNodeResult::Type& OutResult);
+
+	/** Use paths shared between agents when moving from the last reached waypoint */
+	UPROPERTY(EditAnywhere, Category = "Waypoint")
+	uint8 bUsePathCache : 1;
+	/** Cached path is used only if the pawn is at most this far from the waypoint it starts at */
+	UPROPERTY(EditAnywhere, Category = "Waypoint", meta = (EditCondition = "bUsePathCache", ClampMin = "0.0", UIMin = "0.0"))
+	float MaxCachedPathStartOffset = 150.f;
 };
@@ -9,6 +9,10 @@
 /**
  *	This service selects new Waypoint via owner's WaypointFollowerComponent 
  *	and sets it as BB value for further use in MoveToWaypoint.
+ *
+ *	With bDeferSelection the request is queued in UWaypointSelectionSubsystem
+ *	and the key is cleared until the result arrives, so MoveToWaypoint should
+ *	be guarded by a Blackboard decorator observing the key.
  */
 UCLASS(HideCategories = (Service))
 class SIMPLEWAYPOINTS_API USelectWaypoint : public UBTService
@@ -18,9 +22,14 @@ class SIMPLEWAYPOINTS_API USelectWaypoint : public UBTService
 protected:
 	UPROPERTY(EditAnywhere, Category = Blackboard)
 	FBlackboardKeySelector Waypoint;
+	/** Resolve selection in UWaypointSelectionSubsystem's per-frame batch instead of immediately */
+	UPROPERTY(EditAnywhere, Category = "Waypoint")
+	bool bDeferSelection = false;
 
 	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
 	virtual void OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	/** Cancels deferred selection, so its result isn't written for an inactive branch */
+	virtual void OnCeaseRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
 	virtual FString GetStaticDescription() const override;
 
 #if WITH_EDITOR
@@ -5,6 +5,9 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Conditions/BaseCondition.h"
+#include "Conditions/ConditionProgram.h"
+#include "StructUtils/InstancedStruct.h"
+#include <atomic>
 #include "Waypoint.generated.h"
 
 /**
@@ -21,6 +24,43 @@
 
 class UBehaviorTree;
 class UBBValueProvider_Base;
+class AWaypoint;
+class AWaypointGraph;
+struct FWaypointNode;
+
+/** Users counter of a waypoint, shared with reservations so it can be safely released even after waypoint is gone */
+struct FWaypointOccupancy
+{
+	std::atomic<int32> CurrentUsers = 0;
+};
+
+/**
+*	Move only handle of a claimed waypoint user slot.
+*	Releasing is idempotent and happens automatically when the handle is destroyed.
+*/
+struct SIMPLEWAYPOINTS_API FWaypointReservation
+{
+public:
+	FWaypointReservation() = default;
+	FWaypointReservation(FWaypointReservation&& Other);
+	FWaypointReservation& operator=(FWaypointReservation&& Other);
+	FWaypointReservation(const FWaypointReservation&) = delete;
+	FWaypointReservation& operator=(const FWaypointReservation&) = delete;
+	~FWaypointReservation() { Release(); }
+
+	/** Gives the slot back, does nothing if already released */
+	void Release();
+	/** Whether handle holds a slot */
+	bool IsValid() const { return Occupancy.IsValid(); }
+	/** Reserved waypoint, nullptr if released */
+	AWaypoint* GetWaypoint() const { return Occupancy.IsValid() ? Waypoint.Get() : nullptr; }
+
+private:
+	friend class AWaypoint;
+
+	TSharedPtr<FWaypointOccupancy, ESPMode::ThreadSafe> Occupancy;
+	TWeakObjectPtr<AWaypoint> Waypoint;
+};
 
 UCLASS()
 class SIMPLEWAYPOINTS_API AWaypoint : public AActor
@@ -31,10 +71,27 @@ public:
 //~=============================================================================
 // PUBLIC FUNCTIONS	
 
-	/** Called by WaypointFollower upon selection (if is the new one) */
-	void OccupyWaypoint();
-	/** Called by WaypointFollower upon selection (if is the previous one) */
-	void ReleaseWaypoint();
+	/** Claims a user slot if MaxUsers isn't reached. Thread safe, returns invalid handle on failure */
+	FWaypointReservation TryReserve();
+	/** Claims a user slot regardless of MaxUsers, used for fallback selections */
+	FWaypointReservation Reserve();
+
+	// Setup, meant for procedurally built graphs. Owning graph has to be recompiled afterwards
+
+	/** Adds destination or updates its weight */
+	void SetDestination(AWaypoint* Destination, uint8 Weight);
+	/**/
+	void RemoveDestination(AWaypoint* Destination) { Destinations.Remove(Destination); }
+	/**/
+	void SetCooldown(float NewCooldown) { Cooldown = NewCooldown; }
+	/**/
+	void SetMaxUsers(uint8 NewMaxUsers) { MaxUsers = NewMaxUsers; }
+	/** Adds condition instance, it should be outered to this waypoint */
+	void AddCondition(UBaseCondition* Condition);
+	/** Takes settings of a data only waypoint before spawning is finished, conditions are duplicated. Destinations stay in the graph's compiled data */
+	void InitFromNode(const FWaypointNode& Node);
+	/** Fills data only representation except destinations, which are resolved by the graph. Conditions are duplicated into ConditionsOuter */
+	void ToNode(FWaypointNode& OutNode, UObject* ConditionsOuter) const;
 
 	// Getters
 
@@ -42,40 +99,66 @@ public:
 	void GetDestinations(TMap<AWaypoint*, uint8>& OutDestinations) const { OutDestinations = Destinations; }
 	/** Returns copy of destinations */
 	TMap<AWaypoint*, uint8> GetDestinationsCopy() const { return Destinations; }
+	/** Returns destinations without copying */
+	const TMap<AWaypoint*, uint8>& ViewDestinations() const { return Destinations; }
+	/** Dense index in the owning graph's compiled data, INDEX_NONE if not compiled */
+	int32 GetGraphIndex() const { return GraphIndex; }
+	/** Called by the owning graph upon compilation */
+	void SetGraphIndex(int32 NewIndex) { GraphIndex = NewIndex; }
 	/**/
 	float GetCooldown() const { return Cooldown; }
-	/**/
+	/** Route table of the owning graph is updated in place */
 	void SetPointEnabled(bool bNewEnabled);
 	/**/
 	bool IsPointEnabled() const { return bIsEnabled; }
+	/** Route table of the owning graph is updated in place */
+	void SetRouteCostScale(float NewScale);
 	/**/
-	bool IsPointOccupied() const { return CurrentUsers >= MaxUsers; }
+	float GetRouteCostScale() const { return RouteCostScale; }
+	/** Graph this waypoint is attached to, or the one that spawned it from a node */
+	AWaypointGraph* GetOwningGraph() const;
 	/**/
-	bool CheckConditions(AActor* User);
+	bool IsPointOccupied() const { return GetCurrentUsers() >= MaxUsers; }
+	/**/
+	int32 GetCurrentUsers() const { return Occupancy.IsValid() ? Occupancy->CurrentUsers.load(std::memory_order_relaxed) : 0; }
+	/** Results are cached per user as long as all conditions allow it, see UBaseCondition::Volatility. Pending async conditions count as not met */
+	bool CheckConditions(AActor* User) { return PollConditions(User) == EConditionResult::True; }
+	/** Non-blocking check, Pending while async conditions are being evaluated. Only finished results are cached */
+	EConditionResult PollConditions(AActor* User);
+	/** Drops cached condition results of the user, or of everyone if nullptr */
+	void InvalidateConditionCache(const AActor* User = nullptr);
 	/**/
 	bool HasConditions() const { return !UseConditions.IsEmpty(); }
 	/** Get behavior tree meant to be injected after reaching this waypoint */
 	UBehaviorTree* GetDynamicBehavior() const { return Behavior; }
-	/**/
-	const TArray<UBBValueProvider_Base*>& GetBehaviorParams() const { return BehaviorParams; }
+	/** FBBValue structs to set on the blackboard after injecting the behavior */
+	const TArray<FInstancedStruct>& GetBehaviorParams() const { return BehaviorValues; }
 
 	// Debug
 
-#if WITH_EDITOR
-	/** Meant to be called in WaypointGraphComponent::TickComponent */
-	void DrawDestinationsArrows();
-#endif
+	/** Used by UWaypointGraphVisualizer, which draws meshes of the whole graph as instances. Hidden mesh is saved visible */
+	void SetMeshVisible(bool bVisible);
 
 protected:
 
 //~=============================================================================
 // PROTECTED FUNCTIONS
 
-	/** Calls UpdateDebugText() */
+	/** Migrates old BehaviorParams providers, calls UpdateDebugText() */
 	virtual void PostLoad() override;
+	/** Binds condition invalidation */
+	virtual void BeginPlay() override;
+	/** Unbinds condition invalidation */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 #if WITH_EDITOR
 	/** Reacts to bIsEnabled change */
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	/** Updates the owning graph's visualization */
+	virtual void PostEditMove(bool bFinished) override;
+	/** Updates the owning graph's visualization */
+	virtual void PostEditUndo() override;
+	/** Shows the mesh hidden by the visualizer, so it isn't saved hidden */
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
 	/** Updates info about being enabled and current users count */
 	void UpdateDebugText();
 #endif
@@ -97,7 +180,7 @@ protected:
 
 	// Variables
 
-	/** Possible destinations [Destination|Weight] where weight specifies chance for being selected (0 doesn't mean never) */
+	/** Possible destinations [Destination|Weight] where weight specifies chance for being selected (counted as Weight + 1, so 0 doesn't mean never) */
 	UPROPERTY(EditInstanceOnly, Category = "Waypoint")
 	TMap<AWaypoint*, uint8> Destinations;
 	/** For how long in seconds waypoint won't be accessible for single user after failed movement. Lower/equal 0 means no cooldown */
@@ -109,15 +192,18 @@ protected:
 	/** This WP can be selected only by this number of users at the time */
 	UPROPERTY(EditAnywhere, Category = "Waypoint")
 	uint8 MaxUsers = 1;
+	/** Multiplies length of routes entering this WP, makes goal directed followers avoid it if there's a reasonable alternative */
+	UPROPERTY(EditAnywhere, Category = "Waypoint|Routing", meta = (ClampMin = "1.0"))
+	float RouteCostScale = 1.f;
 	/** Whether AI Controller should be injected with dynamic BT upon reaching this WP */
 	UPROPERTY(EditAnywhere, Category = "Waypoint")
 	bool bPerformBehavior = false;
 	/** Dynamic Behavior to inject */
 	UPROPERTY(EditAnywhere, Category = "Waypoint", meta = (EditCondition = "bPerformBehavior"))
 	UBehaviorTree* Behavior;
-	/** Parameters passed to injected Behavior */
-	UPROPERTY(EditAnywhere, Category = "Waypoint", meta = (EditCondition = "bPerformBehavior"), Instanced)
-	TArray<UBBValueProvider_Base*> BehaviorParams;
+	/** Parameters passed to injected Behavior. Plain structs, so they don't cost a UObject each */
+	UPROPERTY(EditAnywhere, Category = "Waypoint", meta = (DisplayName = "Behavior Params", EditCondition = "bPerformBehavior", BaseStruct = "/Script/ExtraLogic.BBValue", ExcludeBaseStruct))
+	TArray<FInstancedStruct> BehaviorValues;
 	/** Match type for conditions */
 	UPROPERTY(EditAnywhere, Category = "Waypoint|Conditions")
 	EConditionMatchType MatchType;
@@ -126,5 +212,47 @@ protected:
 	TArray<UBaseCondition*> UseConditions;
 
 private:
-	uint8 CurrentUsers = 0;
+	/** Instanced providers saved before BehaviorValues, moved there in PostLoad() */
+	UPROPERTY(Instanced)
+	TArray<UBBValueProvider_Base*> BehaviorParams_DEPRECATED;
+
+	friend struct FWaypointReservation;
+
+	struct FConditionCacheEntry
+	{
+		double ExpiryTime;
+		bool bResult;
+	};
+
+	/** Called whenever reservation is made or released, queues debug text update */
+	void OnOccupancyChanged();
+	/** Evaluates UseConditions without touching the cache */
+	EConditionResult EvaluateConditions(AActor* User) const;
+	/** Compiles UseConditions, binds to their invalidation and updates cache lifetime */
+	void CompileConditions();
+	/** */
+	void UnbindConditions();
+	/** Any condition invalidated, results of every user are outdated */
+	void OnConditionInvalidated(const UBaseCondition* Condition);
+	/** Removes expired entries and ones of destroyed users */
+	void PruneConditionCache(double Now);
+
+	/** Created in the constructor, not a TSharedRef since UHT needs UObject members default constructible */
+	TSharedPtr<FWaypointOccupancy, ESPMode::ThreadSafe> Occupancy;
+	int32 GraphIndex = INDEX_NONE;
+
+	/** UseConditions flattened, compiled in BeginPlay or lazily on the first check */
+	FConditionProgram ConditionProgram;
+	/** [User|Cached result] */
+	TMap<TObjectKey<AActor>, FConditionCacheEntry> ConditionCache;
+	/** Shortest cache lifetime among UseConditions, 0 disables caching. Set upon compilation */
+	double ConditionCacheLifetime = 0.0;
+	/** Cache size at which it is pruned next time */
+	int32 NextConditionCachePrune = 32;
+#if WITH_EDITOR
+	/** Set while debug text update is queued, so it happens once per frame however many reservations change */
+	std::atomic<bool> bDebugTextQueued = false;
+	/** Set while the mesh is hidden by SetMeshVisible(), editor state only */
+	bool bMeshHiddenByVisualizer = false;
+#endif
 };
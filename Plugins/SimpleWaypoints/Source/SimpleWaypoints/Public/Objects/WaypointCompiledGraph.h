@@ -0,0 +1,101 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AWaypoint;
+struct FWaypointNode;
+
+/** AWaypointGraph serialization versions */
+struct SIMPLEWAYPOINTS_API FWaypointGraphCustomVersion
+{
+	enum Type
+	{
+		BeforeCustomVersionWasAdded = 0,
+		/** Compiled graph is saved with the graph */
+		CompiledGraphBlob,
+
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	const static FGuid GUID;
+};
+
+/**
+*	Flat runtime representation of waypoint destinations.
+*
+*	Nodes are addressed by dense index matching AWaypointGraph::Waypoints.
+*	Outgoing edges of node N occupy [Offsets[N], Offsets[N + 1]) range of
+*	Destinations and Weights arrays (CSR layout), so selection only walks
+*	a contiguous span instead of hashing actor pointers.
+*
+*	Each node also gets a Walker/Vose alias table built from its weights,
+*	which allows O(1) weighted sampling of a destination. Effective weight
+*	of an edge is Weight + 1, so 0 still gives a chance to be selected.
+*
+*	Compiled data is saved with the graph along with a hash of the data it was
+*	compiled from, so loaded graphs skip compilation unless the waypoints changed.
+*
+*	@see AWaypointGraph
+*/
+struct SIMPLEWAYPOINTS_API FWaypointCompiledGraph
+{
+public:
+	/** Rebuilds adjacency from waypoints' Destinations, data only Nodes get indices after Waypoints. Destinations outside of the given arrays are skipped */
+	void Compile(TConstArrayView<AWaypoint*> Waypoints, TConstArrayView<FWaypointNode> Nodes = {});
+	/** Drops all the data */
+	void Reset();
+	/** Whether the data was compiled from the waypoints in their current state. Without bCheckHash only the node count is compared */
+	bool IsCompiledFrom(TConstArrayView<AWaypoint*> Waypoints, TConstArrayView<FWaypointNode> Nodes, bool bCheckHash) const;
+	/** Sets waypoints' graph indices, done by Compile() and needed after loading */
+	static void AssignGraphIndices(TConstArrayView<AWaypoint*> Waypoints);
+	/** Hash of everything Compile() reads from the waypoints and nodes: order, destinations and their weights */
+	static uint64 ComputeSourceHash(TConstArrayView<AWaypoint*> Waypoints, TConstArrayView<FWaypointNode> Nodes);
+
+	friend FArchive& operator<<(FArchive& Ar, FWaypointCompiledGraph& Graph);
+
+	int32 NumNodes() const { return Offsets.Num() > 0 ? Offsets.Num() - 1 : 0; }
+	/** Incremented on every compilation, lets users of dense indices detect they are stale */
+	uint32 GetVersion() const { return Version; }
+	int32 NumEdges() const { return Destinations.Num(); }
+	bool IsValidNode(int32 Node) const { return Node >= 0 && Node < NumNodes(); }
+
+	/** Index of the first outgoing edge of the node */
+	int32 GetFirstEdge(int32 Node) const { return Offsets[Node]; }
+	/** Number of outgoing edges of the node */
+	int32 GetNumEdges(int32 Node) const { return Offsets[Node + 1] - Offsets[Node]; }
+	/** Destination node indices of the node */
+	TConstArrayView<int32> GetDestinations(int32 Node) const { return MakeArrayView(Destinations).Slice(Offsets[Node], GetNumEdges(Node)); }
+	/** Destination weights of the node, parallel to GetDestinations() */
+	TConstArrayView<uint8> GetWeights(int32 Node) const { return MakeArrayView(Weights).Slice(Offsets[Node], GetNumEdges(Node)); }
+
+	/** Returns weighted random destination node of the node in constant time, INDEX_NONE if it has no edges */
+	int32 SampleDestination(int32 Node) const;
+
+	/** Weight used for selection, keeps zero weighted edges selectable */
+	static int32 GetEffectiveWeight(uint8 Weight) { return int32(Weight) + 1; }
+
+private:
+	/** Builds alias table for the node's edges */
+	void BuildAliasTable(int32 Node);
+
+	/** Per node offsets into edge arrays, NumNodes() + 1 entries */
+	TArray<int32> Offsets;
+	/** Per edge destination node index */
+	TArray<int32> Destinations;
+	/** Per edge selection weight */
+	TArray<uint8> Weights;
+	/** Per edge probability of keeping the sampled slot instead of jumping to its alias */
+	TArray<float> AliasProbabilities;
+	/** Per edge alias, as slot offset relative to the node's first edge */
+	TArray<int32> AliasSlots;
+	/** ComputeSourceHash() of the waypoints the data was compiled from */
+	uint64 SourceHash = 0;
+	/** @see GetVersion() */
+	uint32 Version = 0;
+
+	/** Mixed into source hash, bump it whenever compiled data layout or its meaning changes */
+	static constexpr uint32 FormatVersion = 2;
+};
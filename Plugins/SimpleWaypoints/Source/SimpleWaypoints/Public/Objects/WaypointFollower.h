@@ -5,6 +5,9 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "GameplayTagContainer.h"
+#include "Objects/Waypoint.h"
+#include "Objects/WaypointRouteTable.h"
+#include "Containers/RingBuffer.h"
 #include "WaypointFollower.generated.h"
 
 /**
@@ -25,6 +28,38 @@ class AWaypoint;
 class UBehaviorTree;
 class ACharacter;
 class AAIController;
+struct FWaypointCompiledGraph;
+
+/** Destination candidate gathered from the compiled graph */
+struct FWaypointCandidate
+{
+	/** Dense waypoint index in the graph */
+	int32 Index = INDEX_NONE;
+	/** Selection weight */
+	uint8 Weight = 0;
+	/** Whether candidate is in follower's history, set only if bAvoidVisited */
+	bool bVisited = false;
+};
+
+/** Most waypoints have just a few destinations, so candidates are kept on the stack */
+using FWaypointCandidateArray = TArray<FWaypointCandidate, TInlineAllocator<16>>;
+
+/**
+*	Selection split into phases, so UWaypointSelectionSubsystem can run the data
+*	only filtering of many followers in parallel.
+*	@see UWaypointFollower::BeginSelection
+*/
+struct FWaypointPendingSelection
+{
+	/** Compiled data of the follower's graph */
+	const FWaypointCompiledGraph* Graph = nullptr;
+	/** Node to select destination from, INDEX_NONE if current waypoint isn't part of the graph */
+	int32 FromIndex = INDEX_NONE;
+	/** Destinations left after filtering */
+	FWaypointCandidateArray Candidates;
+	/** Selected waypoint, valid after the selection is resolved */
+	AWaypoint* Result = nullptr;
+};
 
 UCLASS(meta = (BlueprintSpawnableComponent))
 class SIMPLEWAYPOINTS_API UWaypointFollower : public UActorComponent
@@ -36,9 +71,11 @@ public:
 // PUBLIC OVERRIDES
 //====================================================================
 
-	/** Used to reserve memory for IgnoredWaypoints array; to setup demo BT and to set debug config */
+	/** Used to reserve memory for the history; to setup demo BT and to set debug config */
 	virtual void BeginPlay() override;
-	/** Manages waypoints cooldowns and debugs */
+	/** Releases current waypoint's reservation */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	/** Draws debugs, tick is enabled only with bEnableDebug */
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 //====================================================================
@@ -48,24 +85,52 @@ public:
 	/**/
 	UFUNCTION(BlueprintCallable, Category = "WaypointFollower")
 	static UWaypointFollower* GetWaypointFollower(AActor* Owner);
-	/**/
+	/** History and route of the previous graph are dropped, their indices don't apply to the new one */
 	UFUNCTION(BlueprintCallable, Category = "WaypointFollower")
-	void SetWaypointGraph(AWaypointGraph* Graph) { WaypointGraph = Graph; }
+	void SetWaypointGraph(AWaypointGraph* Graph);
 	/** Adds current waypoint to the history and sets dynamic behavior if it has one */
 	UFUNCTION(BlueprintCallable, Category = "WaypointFollower")
 	virtual void ReachWaypoint();
-	/** Tries to set a new CurrentWaypoint from available ones and returns reference to it */
+	/** Tries to set a new CurrentWaypoint from available ones and returns reference to it. Pending async conditions count as not met */
 	UFUNCTION(BlueprintCallable, Category = "WaypointFollower")
 	virtual AWaypoint* SelectWaypoint();
+	/**
+	*	Same as SelectWaypoint(), but with bAllowPending it can wait for async conditions: returns false without
+	*	changing CurrentWaypoint if no destination is available yet and some are still being evaluated.
+	*	Call it again later, finished results are reused by the conditions.
+	*/
+	bool TrySelectWaypoint(AWaypoint*& OutWaypoint, bool bAllowPending);
 	/** Makes waypoint temporarily unavailable for the owner (as a result of failed movement by default) */
 	UFUNCTION(BlueprintCallable, Category = "WaypointFollower")
 	virtual void IgnoreWaypoint(AWaypoint* Waypoint);
+	/**
+	*	Switches to goal directed mode: selection picks the next waypoint of the shortest route to Goal
+	*	instead of a random destination. If the next one isn't available, a random destination is picked
+	*	and the route continues from there. Goal is dropped once reached or if it's unreachable, nullptr clears it.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "WaypointFollower")
+	void SetGoalWaypoint(AWaypoint* Goal);
+	/**/
+	UFUNCTION(BlueprintPure, Category = "WaypointFollower")
+	AWaypoint* GetGoalWaypoint() const { return GoalWaypoint.Get(); }
+
+	// Phased selection, SelectWaypoint() is equivalent of calling these in order
+
+	/** Game thread. Returns false if selection was resolved right away (no graph, current one not reached yet, etc.) */
+	bool BeginSelection(FWaypointPendingSelection& OutSelection);
+	/** Any thread. Gathers destinations and filters out ones on cooldown or occupied, doesn't check conditions */
+	void FilterPendingSelection(FWaypointPendingSelection& Selection) const;
+	/** Game thread. Checks conditions, picks a destination and occupies it. Returns false if it waits for async conditions, see TrySelectWaypoint() */
+	bool FinishSelection(FWaypointPendingSelection& Selection, bool bAllowPending = false);
 
 	// WP Getters 
 
 	UFUNCTION(BlueprintPure, Category = "WaypointFollower")
 	const AWaypoint* GetCurrentWaypoint() const { return CurrentWaypoint.Get(); }
-	const TArray<AWaypoint*>& GetVisitedWaypoints() const { return VisitedWaypoints; }
+	/** Waypoint the owner stands at (or left last), null before reaching the first one */
+	const AWaypoint* GetLastReachedWaypoint() const { return LastReachedWaypoint.Get(); }
+	/** Returns history, oldest first. Released node waypoints are null */
+	void GetVisitedWaypoints(TArray<AWaypoint*>& OutWaypoints) const;
 	const FGameplayTag GetInjectTag() const { return DynamicBehaviorTag; }
 
 //====================================================================
@@ -76,9 +141,13 @@ protected:
 
 	// Protected Setters 
 
-	/** Sets CurrentWaypoint and additionally Calls ReleaseWaypoint() and OccupyWaypoint() */
+	/** Sets CurrentWaypoint, releases previous reservation and reserves the new waypoint regardless of its MaxUsers */
 	UFUNCTION(BlueprintCallable, Category = "WaypointFollower")
 	void SetCurrentWaypoint(AWaypoint* Waypoint);
+	/** Sets reserved waypoint as CurrentWaypoint, releases previous reservation */
+	void SetReservedWaypoint(FWaypointReservation&& Reservation);
+	/** Sets selected destination or fallback one if nothing was selected */
+	void CommitSelection(FWaypointReservation&& Reservation);
 
 	// Getters
 
@@ -87,42 +156,56 @@ protected:
 
 	// Filtering 
 
-	/** Checks availability of destinations */
-	void FilterDestinations(TMap<AWaypoint*, uint8>& Waypoints) const;
-	/** Checks waypoint's Conditions array */
-	bool DoesMeetConditions(AWaypoint* Waypoint) const;
-	/** Checks whether waypoint is in the IgnoredWaypoints TMap */
-	bool IsOnCooldown(AWaypoint* Waypoint) const;
-	/** Checks if waypoint's max users number was reached */
-	bool IsOccupied(AWaypoint* Waypoint) const;
-	/** Checks whether waypoint is in the VisitedWaypoints TArray */
-	bool WasVisited(AWaypoint* Waypoint) const;
-	AWaypoint* GetRandomWaypoint(TMap<AWaypoint*, uint8>& Destinations) const;
+	/** Picks and reserves weighted random destination of the node that passes filtering. bOutPending is set if nothing was picked while some conditions are pending */
+	FWaypointReservation PickDestination(const FWaypointCompiledGraph& Graph, int32 FromIndex, bool* bOutPending = nullptr) const;
+	/** Collects outgoing edges of the node from the compiled graph */
+	void GatherDestinations(const FWaypointCompiledGraph& Graph, int32 FromIndex, FWaypointCandidateArray& OutCandidates) const;
+	/** Checks availability of destinations, returns number of ones removed due to pending conditions */
+	int32 FilterDestinations(const FWaypointCompiledGraph& Graph, FWaypointCandidateArray& Candidates) const;
+	/** Thread safe part of filtering: cooldowns, occupation and marking visited ones */
+	void FilterDestinationsData(const FWaypointCompiledGraph& Graph, FWaypointCandidateArray& Candidates) const;
+	/** Removes destinations whose conditions aren't met or are pending, game thread only. Returns number of pending ones */
+	int32 FilterDestinationsConditions(FWaypointCandidateArray& Candidates) const;
+	/** Removes visited destinations if there's anything else left */
+	void FilterDestinationsVisited(FWaypointCandidateArray& Candidates) const;
+	/** Checks cooldown, occupation and conditions of a single destination, game thread only. Pending conditions make it unavailable and set bOutPending */
+	bool IsAvailable(const FWaypointCompiledGraph& Graph, int32 Index, bool* bOutPending = nullptr) const;
+	/** Polls conditions of the graph point, spawns node waypoints only if they have any. Game thread only */
+	EConditionResult PollConditions(int32 Index) const;
+	/** Checks whether point's cooldown end in the IgnoredIndices TMap hasn't passed yet */
+	bool IsOnCooldown(const FWaypointCompiledGraph& Graph, int32 Index) const;
+	/** Checks if point's max users number was reached, doesn't spawn node waypoints */
+	bool IsOccupied(int32 Index) const;
+	/** Checks whether graph node is in the history, a single lookup. History of older graph versions doesn't count */
+	bool WasVisited(const FWaypointCompiledGraph& Graph, int32 Index) const;
+	/** Weighted random pick, used when alias sampling keeps hitting unavailable destinations. Returns index in Candidates */
+	int32 GetRandomCandidate(const FWaypointCandidateArray& Candidates) const;
+	/** Picks random candidates until one of them can be reserved, removes the ones that can't */
+	FWaypointReservation ReserveRandomWaypoint(FWaypointCandidateArray& Candidates) const;
+	/** Reserves next waypoint of the route to GoalWaypoint if it's available, drops the goal if it's reached or unreachable */
+	FWaypointReservation ReserveRouteHop(int32 FromIndex);
 
 	// Other
 
 	void AddToHistory(AWaypoint* Waypoint);
-	void TickCooldowns(float DeltaTime);
+	/** Assigns waypoint the graph has to keep alive, moves the pin from the previous one */
+	void SetPinnedWaypoint(TObjectPtr<AWaypoint>& Slot, AWaypoint* Waypoint);
+	/** Removes expired entries from IgnoredIndices */
+	void PruneCooldowns(double Now);
 	bool IsWaypointReached(AWaypoint* Waypoint) const;
 	void SetWaypointBehaviorParameters(AWaypoint* Waypoint);
 
-	// Debug
-#if !UE_BUILD_SHIPPING
-	void DebugLog(FString Message) const;
-	void DebugLogWaypoint(AWaypoint* Waypoint, FString Message) const;
-#endif
-
 //====================================================================
 // PROTECTED PROPERTIES
 //====================================================================
 
 	/** Max number of stored visited waypoints */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WaypointFollower|Config")
-	uint8 HistoryLimit = 5;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WaypointFollower|Config", meta = (ClampMin = "0", ClampMax = "65535"))
+	int32 HistoryLimit = 5;
 	/** If true and no destination is available, owner will pick the first one from WaypointGraph */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WaypointFollower|Config")
 	uint8 bLoopPath : 1;
-	/** If true and multiple destinations are available, owner will skip the ones in VisitedWaypoints */
+	/** If true and multiple destinations are available, owner will skip the ones in history */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WaypointFollower|Config")
 	uint8 bAvoidVisited : 1;
 	/** If reached waypoint contains dynamic behavior, it will be injected to owner's AIController with this tag */
@@ -150,12 +233,29 @@ private:
 // PRIVATE PROPERTIES
 //====================================================================
 
+	/** Last HistoryLimit reached waypoints as dense graph indices, oldest first */
+	TRingBuffer<int32> VisitedIndices;
+	/** [Dense graph index|Occurrences in VisitedIndices], sized by the history rather than the graph */
+	TMap<int32, uint16> VisitCounts;
+	/** Compiled graph version the history was recorded with */
+	uint32 HistoryVersion = 0;
+	/** Last waypoint passed to AddToHistory(), pinned in WaypointGraph */
 	UPROPERTY(VisibleInstanceOnly)
-	TArray<AWaypoint*> VisitedWaypoints;
+	TObjectPtr<AWaypoint> LastReachedWaypoint;
 	UPROPERTY(VisibleInstanceOnly)
 	TObjectPtr<AWaypoint> CurrentWaypoint;
+	/** User slot of CurrentWaypoint, released automatically with the follower */
+	FWaypointReservation CurrentReservation;
+	/** Target of goal directed mode, see SetGoalWaypoint(). Pinned in WaypointGraph */
+	UPROPERTY(VisibleInstanceOnly)
+	TObjectPtr<AWaypoint> GoalWaypoint;
+	/** Route to GoalWaypoint of large graphs, search buffers are shared per thread */
+	FWaypointRouteScratch RouteScratch;
+	/** [Dense graph index|World time when its cooldown ends], expired entries are pruned lazily in IgnoreWaypoint(). Indices outlive released node waypoints */
 	UPROPERTY(VisibleInstanceOnly)
-	TMap<AWaypoint*, float> IgnoredWaypoints;
+	TMap<int32, double> IgnoredIndices;
+	/** Compiled graph version the cooldowns were recorded with */
+	uint32 CooldownVersion = 0;
 
 	mutable TWeakObjectPtr<AAIController> OwnerController;
 	mutable TWeakObjectPtr<ACharacter> OwnerCharacter;
@@ -4,11 +4,22 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "UObject/ObjectKey.h"
+#include "Objects/WaypointSpatialIndex.h"
+#include "Objects/WaypointCompiledGraph.h"
+#include "Objects/WaypointRouteTable.h"
+#include "Objects/WaypointNode.h"
 #include "WaypointGraph.generated.h"
 
 /**
 *	Waypoint graph, as an attach parent for waypoints, defines the scope
 *	of path selection available for the user.
+*
+*	Besides attached actors, the graph may hold data only waypoints (Nodes),
+*	which get dense indices after Waypoints and are spawned as actors only
+*	once followers need them, on game thread. Actors of nodes nobody uses are
+*	destroyed again, see SimpleWaypoints.NodeWaypointReleaseInterval.
+*	Large graphs should be collapsed into nodes.
 * 
 *	@see AWaypoint
 *	@see UWaypointFollower
@@ -17,6 +28,7 @@
 class AWaypoint;
 class UTextRenderComponent;
 class UBillboardComponent;
+class UWaypointGraphVisualizer;
 
 UCLASS(HideCategories = (Materials, Rendering, Lighting, Physics, Collision, LOD))
 class SIMPLEWAYPOINTS_API AWaypointGraph : public AActor
@@ -35,32 +47,80 @@ public:
 	int32 GetWaypointCount() const { return Waypoints.Num(); }
 	UFUNCTION(BlueprintPure, Category = "WaypointGraph")
 	void GetWaypoints(TArray<AWaypoint*>& OutWaypoints) const { OutWaypoints = Waypoints; }
+	/** Returns waypoint by its dense index (@see AWaypoint::GetGraphIndex). Waypoints of nodes are spawned on request during play, game thread only. Null in editor */
+	AWaypoint* GetWaypoint(int32 Index) const;
+	/** Same as GetWaypoint(), but never spawns. Null for nodes without an actor */
+	AWaypoint* FindWaypoint(int32 Index) const;
+	/** Whether the point reached its MaxUsers. Doesn't spawn anything, safe during parallel selection */
+	bool IsPointOccupied(int32 Index) const;
+	/** Whether the point has use conditions, checking them needs its actor */
+	bool PointHasConditions(int32 Index) const;
+	/** Keeps node waypoint from being released while a follower refers to it (goal, last reached), calls are counted. Null is ignored */
+	void PinWaypoint(const AWaypoint* Waypoint);
+	/** Reverts PinWaypoint() */
+	void UnpinWaypoint(const AWaypoint* Waypoint);
+	/** Number of dense indices, attached waypoints and nodes */
+	int32 GetNumPoints() const { return Waypoints.Num() + Nodes.Num(); }
+	/** Location of a waypoint or node, doesn't spawn anything */
+	FVector GetPointLocation(int32 Index) const;
+	/** Returns adjacency data, compiles it first if waypoints have changed */
+	const FWaypointCompiledGraph& GetCompiledGraph();
+	/** Returns shortest routes data, built on the first use after the graph or enabled states changed */
+	const FWaypointRouteTable& GetRouteTable();
 	UFUNCTION(BlueprintPure, Category = "WaypointGraph|PointSelection")
-	AWaypoint* GetFirstPoint() const { return Waypoints[0]; }
+	AWaypoint* GetFirstPoint() const { return GetWaypoint(0); }
 	UFUNCTION(BlueprintPure, Category = "WaypointGraph|PointSelection")
 	AWaypoint* GetRandomPoint() const;
 	UFUNCTION(BlueprintPure, Category = "WaypointGraph|PointSelection")
 	AWaypoint* GetFarthestPoint(const FVector& ToLocation) const;
 	UFUNCTION(BlueprintPure, Category = "WaypointGraph|PointSelection")
 	AWaypoint* GetNearestPoint(const FVector& ToLocation) const;
+	/** Returns up to Count waypoints closest to the location, sorted by distance */
+	UFUNCTION(BlueprintCallable, Category = "WaypointGraph|PointSelection")
+	void GetNearestPoints(const FVector& ToLocation, int32 Count, TArray<AWaypoint*>& OutWaypoints) const;
+	/** Allocation free version of GetNearestPoints(), fills OutIndices with Waypoints array indices and returns their number */
+	int32 GetNearestPointIndices(const FVector& ToLocation, TArrayView<int32> OutIndices) const;
 
 	// Waypoint management
 
 	void AddWaypoint(AWaypoint* NewWaypoint);
 	void RemoveWaypoint(AWaypoint* Waypoint);
+	/** Rebuilds SpatialIndex from current waypoint locations. Waypoints are assumed to stay in place during play */
+	void RebuildSpatialIndex();
+	/** Rebuilds CompiledGraph from waypoints' destinations */
+	void CompileGraph();
+	/** Defers recompilation until next GetCompiledGraph(), call it after changing waypoints' destinations */
+	void InvalidateCompiledGraph() { bCompiledGraphDirty = true; MarkVisualizationDirty(); }
+	/** Defers route table rebuild until next GetRouteTable() */
+	void InvalidateRouteTable() { bRouteTableDirty = true; }
+	/** Repairs built route table after the waypoint's enabled state or route cost changed, instead of rebuilding it */
+	void UpdateWaypointRouting(AWaypoint* Waypoint);
+
+	// Debug
+
+	/** Rebuilds Visualizer on the next editor tick, call it after waypoints moved or their destinations changed */
+	void MarkVisualizationDirty();
 
 protected:
 
 	//~====================================================================
 	// PROTECTED OVERRIDES
 
-	/** Disables GraphComponent's tick */
+	/** Builds runtime data */
 	virtual void BeginPlay() override;
 	/** Clears invalid Waypoints array entries */
 	virtual void PostLoad() override;
+	/** Saves and loads CompiledGraph along with the properties */
+	virtual void Serialize(FArchive& Ar) override;
 #if WITH_EDITOR
+	/** Recompiles the graph if waypoints changed since the last compilation and reports dead ends and unreachable waypoints */
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
 	/** Tracks actor name changes for debug text */
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	/** Nodes move along with the graph */
+	virtual void PostEditMove(bool bFinished) override;
+	/** Waypoints or nodes may have been restored, recompiles and updates visualization */
+	virtual void PostEditUndo() override;
 #endif
 
 	//~====================================================================
@@ -69,6 +129,14 @@ protected:
 	/** Adds a new waypoint of class specified in DefaultWaypointClass */
 	UFUNCTION(BlueprintCallable, Category = "WaypointGraph", CallInEditor)
 	void CreateWaypoint();
+#if WITH_EDITOR
+	/** Turns attached waypoints into data only nodes and destroys the actors. Destinations of waypoints outside the graph pointing at them are lost */
+	UFUNCTION(CallInEditor, Category = "WaypointGraph|Nodes")
+	void CollapseWaypoints();
+	/** Spawns attached waypoints from nodes for editing, nodes are removed */
+	UFUNCTION(CallInEditor, Category = "WaypointGraph|Nodes")
+	void ExpandNodes();
+#endif
 
 public:
 
@@ -81,6 +149,9 @@ public:
 	TArray<AWaypoint*> Waypoints;
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "WaypointGraph")
 	TArray<APawn*> GraphUsers;
+	/** Data only waypoints, cheaper than actors for large graphs */
+	UPROPERTY(EditAnywhere, Category = "WaypointGraph|Nodes")
+	TArray<FWaypointNode> Nodes;
 
 	/** Components */
 
@@ -91,6 +162,9 @@ public:
 	UTextRenderComponent* TextComponent;
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly)
 	UBillboardComponent* BillboardComponent;
+	/** Draws all waypoints and destinations of the graph in a couple of draw calls */
+	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly)
+	UWaypointGraphVisualizer* Visualizer;
 #endif
 
 protected:
@@ -101,12 +175,51 @@ protected:
 	/** Class for CreateWaypoint() */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "WaypointGraph")
 	TSubclassOf<AWaypoint> DefaultWaypointClass;
+
+private:
+
+	/** Whether SpatialIndex matches the Waypoints array, otherwise queries fall back to linear search */
+	bool IsSpatialIndexValid() const { return SpatialIndex.Num() == GetNumPoints(); }
+	/** Spawns actor of the node for followers, not attached to the graph */
+	AWaypoint* SpawnNodeWaypoint(int32 NodeIndex);
+	/** Destroys actors of nodes that had no users since the previous call, runs on a timer during play */
+	void ReleaseUnusedNodeWaypoints();
+	/** Updates graph indices of spawned node waypoints after Waypoints changed */
+	void AssignNodeIndices();
+	/** Takes loaded CompiledGraph into use if it still matches the waypoints, otherwise marks it for recompilation */
+	void AdoptLoadedGraph();
+#if WITH_EDITOR
+	/** Logs waypoints without destinations and ones that can't be reached from the first waypoint */
+	void ValidateCompiledGraph() const;
+#endif
+
+	/** Actors spawned from Nodes, same indices. Kept alive by the level until released. Sized on compilation, so parallel readers never see it resized */
+	mutable TArray<TWeakObjectPtr<AWaypoint>> NodeWaypoints;
+	/** Node actors without users at the last ReleaseUnusedNodeWaypoints(), released on the next one if they stay so */
+	TBitArray<> IdleNodeWaypoints;
+	/** Runs ReleaseUnusedNodeWaypoints() */
+	FTimerHandle ReleaseNodeWaypointsTimer;
+	/** [Waypoint|Number of pins], never released. Keyed by actor, so pins survive recompilation */
+	TMap<TObjectKey<AWaypoint>, int32> PinnedWaypoints;
+	/** Point queries acceleration, indices are dense graph indices */
+	FWaypointSpatialIndex SpatialIndex;
+	/** Destinations adjacency, indices match Waypoints array */
+	FWaypointCompiledGraph CompiledGraph;
+	/** Set when Waypoints array changes, compilation is deferred until next GetCompiledGraph() */
+	bool bCompiledGraphDirty = true;
+	/** Set when CompiledGraph was loaded, it's checked against the waypoints on the first use */
+	bool bCompiledGraphLoaded = false;
+	/** Goal directed routes over CompiledGraph */
+	FWaypointRouteTable RouteTable;
+	/** Set on graph compilation */
+	bool bRouteTableDirty = true;
 };
 
 /**
 *	This Component's main purposes are to:
-*	- Notify the owner (AWaypointGraph) about Attach/Detach events, 
-*	- Draw debug arrows to visualize destinations
+*	- Notify the owner (AWaypointGraph) about Attach/Detach events
+*
+*	Destinations are visualized by UWaypointGraphVisualizer.
 */
 
 UCLASS()
@@ -121,11 +234,6 @@ protected:
 	virtual void OnChildAttached(USceneComponent* ChildComponent) override;
 	virtual void OnChildDetached(USceneComponent* ChildComponent) override;
 	virtual void OnRegister() override;
-	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
-#if WITH_EDITOR
-	void DrawArrows();
-#endif // with editor
 
 	TWeakObjectPtr<AWaypointGraph> OwnerGraph;
 };
\ No newline at end of file
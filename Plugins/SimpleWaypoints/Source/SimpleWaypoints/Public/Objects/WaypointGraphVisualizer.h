@@ -0,0 +1,95 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "WaypointGraphVisualizer.generated.h"
+
+/**
+*	Editor visualization of a whole waypoint graph in a couple of draw calls.
+*
+*	Waypoints and data only nodes are instances of this component, destinations
+*	are arrows in a single line batch. Both are rebuilt only after the graph
+*	reports a change (@see AWaypointGraph::MarkVisualizationDirty) or selection
+*	of the graph or its waypoints changes, at most once per frame.
+*
+*	Only destinations of the selected graph or waypoints are drawn, in foreground,
+*	unless bDrawDestinations is set.
+*
+*	Meshes of attached waypoints are hidden while the graph is visualized, they are
+*	still saved visible. Clicking an instance selects its waypoint, instances of
+*	nodes select the graph.
+*
+*	@see AWaypointGraph
+*/
+
+class AWaypoint;
+class AWaypointGraph;
+class ULineBatchComponent;
+struct FBatchedLine;
+struct FWaypointNode;
+
+UCLASS(ClassGroup = (Waypoints))
+class SIMPLEWAYPOINTS_API UWaypointGraphVisualizer : public UInstancedStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UWaypointGraphVisualizer(const FObjectInitializer& ObjectInitializer);
+
+	/** Schedules rebuild for the next tick, cheap to call multiple times per frame */
+	void MarkVisualizationDirty();
+	/** Rebuilds instances and arrows right away */
+	void RebuildVisualization();
+
+protected:
+	/** Creates the line batch and schedules the first rebuild */
+	virtual void OnRegister() override;
+	/** Destroys the line batch and shows waypoint meshes again */
+	virtual void OnUnregister() override;
+	/** Only enabled while a rebuild is pending */
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	/** Instance hit proxies select the waypoint the instance stands for */
+	virtual void CreateHitProxyData(TArray<TRefCountPtr<HHitProxy>>& HitProxies) override;
+
+	/** Hide meshes of attached waypoints, so they aren't drawn twice */
+	UPROPERTY(EditAnywhere, Category = "Visualization")
+	bool bHideWaypointMeshes = true;
+	/** Draw destinations of unselected waypoints too, selected ones are always drawn */
+	UPROPERTY(EditAnywhere, Category = "Visualization")
+	bool bDrawDestinations = false;
+	/** */
+	UPROPERTY(EditAnywhere, Category = "Visualization", meta = (ClampMin = "0.0", EditCondition = "bDrawDestinations"))
+	float ArrowSize = 50.f;
+
+private:
+	/** Appends line and head of an arrow */
+	void AddArrow(TArray<FBatchedLine>& Lines, const FVector& Start, const FVector& End, const FLinearColor& Color, float Thickness, uint8 DepthPriority) const;
+	/** Appends arrows of the waypoint's destinations */
+	void AddWaypointArrows(TArray<FBatchedLine>& Lines, const AWaypoint& Waypoint, uint8 DepthPriority) const;
+	/** Appends arrows of the node's destinations */
+	void AddNodeArrows(TArray<FBatchedLine>& Lines, const AWaypointGraph& Graph, const FWaypointNode& Node, uint8 DepthPriority) const;
+	/** Shows or hides meshes of the graph's attached waypoints */
+	void SetWaypointMeshesVisible(bool bVisible) const;
+#if WITH_EDITOR
+	/** Selected waypoints of the graph, usually just a few */
+	using FWaypointSelection = TArray<TObjectKey<AWaypoint>, TInlineAllocator<8>>;
+
+	/** Selected state of the graph and its selected waypoints. Goes through selected actors only, not the whole graph */
+	void GetSelection(bool& bOutGraphSelected, FWaypointSelection& OutWaypoints) const;
+	/** Marks dirty only if selection of the graph or its waypoints changed */
+	void OnSelectionChanged(UObject* Selection);
+
+	/** Selection arrows were drawn for */
+	bool bDrawnGraphSelected = false;
+	FWaypointSelection DrawnWaypoints;
+	FDelegateHandle SelectionChangedHandle;
+#endif
+
+	/** Waypoint of each instance, null for nodes */
+	TArray<TWeakObjectPtr<AWaypoint>> InstanceWaypoints;
+	/** Destination arrows, lines never expire and are flushed on rebuild */
+	UPROPERTY(Transient)
+	TObjectPtr<ULineBatchComponent> DestinationLines;
+};
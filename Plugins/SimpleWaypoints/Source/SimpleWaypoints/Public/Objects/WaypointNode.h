@@ -0,0 +1,77 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Conditions/BaseCondition.h"
+#include "StructUtils/InstancedStruct.h"
+#include "WaypointNode.generated.h"
+
+class UBehaviorTree;
+
+/** Outgoing edge of a data only waypoint */
+USTRUCT()
+struct SIMPLEWAYPOINTS_API FWaypointNodeDestination
+{
+	GENERATED_BODY()
+
+	/** Index in AWaypointGraph::Nodes */
+	UPROPERTY(EditAnywhere, Category = "Waypoint")
+	int32 Node = INDEX_NONE;
+	/** Chance for being selected, counted as Weight + 1 */
+	UPROPERTY(EditAnywhere, Category = "Waypoint")
+	uint8 Weight = 0;
+};
+
+/**
+*	Data only waypoint, stored in AWaypointGraph::Nodes instead of being an actor.
+*
+*	Carries the same settings as AWaypoint. An actor is spawned for a node only once
+*	a follower reserves it or its conditions have to be checked, and destroyed after
+*	it stays unused, so large graphs don't pay for actors and components of waypoints
+*	nobody walks to. Cooldown and occupancy of nodes without actors are checked by index.
+*
+*	Destinations refer to other nodes of the same graph.
+*
+*	@see AWaypointGraph::CollapseWaypoints
+*	@see AWaypointGraph::ExpandNodes
+*/
+USTRUCT()
+struct SIMPLEWAYPOINTS_API FWaypointNode
+{
+	GENERATED_BODY()
+
+	/** Relative to the owning graph */
+	UPROPERTY(EditAnywhere, Category = "Waypoint", meta = (MakeEditWidget))
+	FVector Location = FVector::ZeroVector;
+	/** @see AWaypoint::Destinations */
+	UPROPERTY(EditAnywhere, Category = "Waypoint")
+	TArray<FWaypointNodeDestination> Destinations;
+	/** @see AWaypoint::Cooldown */
+	UPROPERTY(EditAnywhere, Category = "Waypoint")
+	float Cooldown = -1.f;
+	/** @see AWaypoint::bIsEnabled */
+	UPROPERTY(EditAnywhere, Category = "Waypoint")
+	bool bIsEnabled = true;
+	/** @see AWaypoint::MaxUsers */
+	UPROPERTY(EditAnywhere, Category = "Waypoint")
+	uint8 MaxUsers = 1;
+	/** @see AWaypoint::RouteCostScale */
+	UPROPERTY(EditAnywhere, Category = "Waypoint|Routing", meta = (ClampMin = "1.0"))
+	float RouteCostScale = 1.f;
+	/** @see AWaypoint::bPerformBehavior */
+	UPROPERTY(EditAnywhere, Category = "Waypoint")
+	bool bPerformBehavior = false;
+	/** @see AWaypoint::Behavior */
+	UPROPERTY(EditAnywhere, Category = "Waypoint", meta = (EditCondition = "bPerformBehavior"))
+	UBehaviorTree* Behavior = nullptr;
+	/** @see AWaypoint::BehaviorValues */
+	UPROPERTY(EditAnywhere, Category = "Waypoint", meta = (DisplayName = "Behavior Params", EditCondition = "bPerformBehavior", BaseStruct = "/Script/ExtraLogic.BBValue", ExcludeBaseStruct))
+	TArray<FInstancedStruct> BehaviorValues;
+	/** @see AWaypoint::MatchType */
+	UPROPERTY(EditAnywhere, Category = "Waypoint|Conditions")
+	EConditionMatchType MatchType = EConditionMatchType::ALL;
+	/** Outered to the graph, duplicated into the waypoint once it's spawned */
+	UPROPERTY(EditAnywhere, Category = "Waypoint|Conditions", Instanced, meta = (NoElementDuplicate, TitleProperty = "ConditionName"))
+	TArray<UBaseCondition*> UseConditions;
+};
@@ -0,0 +1,152 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AWaypoint;
+struct FWaypointCompiledGraph;
+struct FWaypointNode;
+struct FWaypointRouteTable;
+
+/**
+*	Last found route of FWaypointRouteTable queries.
+*
+*	Owned by the querying side (e.g. a follower), so its size is the length of
+*	the route, not of the graph. Followers walking the route hit the cached path,
+*	so A* runs once per goal. Node sized search buffers are per thread, @see FindPath().
+*/
+struct SIMPLEWAYPOINTS_API FWaypointRouteScratch
+{
+public:
+	/** Forgets the cached route, buffers are kept */
+	void Reset() { Path.Reset(); PathGoal = INDEX_NONE; }
+
+private:
+	friend struct FWaypointRouteTable;
+
+	/** Last route, start node first. Just the start node if the goal wasn't reachable */
+	TArray<int32> Path;
+	/** Route length from the start node, parallel to Path */
+	TArray<float> PathCosts;
+	/** Index of Path entry the last query started from */
+	int32 PathCursor = 0;
+	int32 PathGoal = INDEX_NONE;
+	uint32 PathVersion = 0;
+	bool bPathFound = false;
+};
+
+/**
+*	Shortest routes between waypoints of a compiled graph. Edges are weighted by distance,
+*	scaled by route cost of the destination waypoint (@see AWaypoint::RouteCostScale).
+*
+*	Graphs up to SimpleWaypoints.RouteTableMaxNodes nodes get a precomputed next hop table,
+*	so every query is a single lookup. Larger graphs are searched with A* on demand,
+*	with the resulting route kept in FWaypointRouteScratch.
+*
+*	Disabled waypoints are never entered, but a route may start at one.
+*	Topology is copied from FWaypointCompiledGraph, so the table has to be rebuilt
+*	whenever the graph is recompiled. Enabled states and route costs can be changed
+*	in place: A* just reads the new data, next hop table gets repaired only
+*	where the routes are affected (subtrees of the shortest path trees).
+*
+*	@see AWaypointGraph::GetRouteTable
+*	@see UWaypointFollower::SetGoalWaypoint
+*/
+struct SIMPLEWAYPOINTS_API FWaypointRouteTable
+{
+public:
+	/** Rebuilds routing data. Waypoints and Nodes have to be the arrays Graph was compiled from, node locations are transformed by NodesTransform */
+	void Build(const FWaypointCompiledGraph& Graph, TConstArrayView<AWaypoint*> Waypoints, TConstArrayView<FWaypointNode> Nodes = {}, const FTransform& NodesTransform = FTransform::Identity);
+	/** Drops all the data */
+	void Reset();
+
+	int32 NumNodes() const { return Offsets.Num() > 0 ? Offsets.Num() - 1 : 0; }
+	bool IsValidNode(int32 Node) const { return Node >= 0 && Node < NumNodes(); }
+	/** Incremented whenever routes may have changed, invalidates routes cached in scratches */
+	uint32 GetVersion() const { return Version; }
+	/** Whether routes are precomputed, otherwise queries run A* */
+	bool HasNextHopTable() const { return !NextHops.IsEmpty(); }
+
+	/** First node after From on the shortest route to Goal. INDEX_NONE if Goal is unreachable, Goal if From is Goal */
+	int32 GetNextHop(int32 From, int32 Goal, FWaypointRouteScratch& Scratch) const;
+	/** Length of the shortest route from From to Goal, negative if Goal is unreachable */
+	float GetRouteDistance(int32 From, int32 Goal, FWaypointRouteScratch& Scratch) const;
+
+	// Incremental updates, game thread only
+
+	/** Enables or disables entering the node, affected routes are repaired */
+	void SetNodeEnabled(int32 Node, bool bEnabled);
+	/** Scales cost of edges leading to the node, affected routes are repaired. Has to be at least 1, so A* heuristic stays admissible */
+	void SetNodeCostScale(int32 Node, float CostScale);
+
+private:
+	struct FIncomingEdge
+	{
+		int32 Source;
+		int32 Edge;
+	};
+
+public:
+	/** Entry of Dijkstra and A* binary heaps */
+	struct FOpenNode
+	{
+		float Priority;
+		float Cost;
+		int32 Node;
+
+		bool operator<(const FOpenNode& Other) const { return Priority < Other.Priority; }
+	};
+
+private:
+
+	/** Whether routes to Goal may pass through the node */
+	bool CanEnter(int32 Node, int32 Goal) const { return Node == Goal || EnabledNodes[Node]; }
+	/** Builds edge arrays once Positions and EnabledNodes are filled, then the next hop table if the graph is small enough */
+	void BuildEdges(int32 NumGraphEdges, TFunctionRef<TConstArrayView<int32>(int32)> GetNodeDestinations, TConstArrayView<float> CostScales);
+	/** Runs Dijkstra towards every enabled node over reversed edges */
+	void BuildNextHopTable();
+	/** Recomputes routes to Goal from scratch */
+	void BuildRow(int32 Goal);
+	/** Marks every node as unable to reach Goal */
+	void ClearRow(int32 Goal);
+	/** Drops routes to Goal going through Roots, then reattaches them to the rest of the routes */
+	void RepairRow(int32 Goal, TConstArrayView<int32> Roots);
+	/** Dijkstra over reversed edges from nodes in RowOpen, only improves distances to Goal */
+	void RelaxRow(int32 Goal);
+	/** Updates cost of a single edge, repairs routes using it or ones that got shorter */
+	void SetEdgeCost(int32 Source, int32 Destination, int32 Edge, float NewCost);
+	/** Returns index of From in the scratch's route to Goal, runs A* first if there's no such route */
+	int32 FindInPath(int32 From, int32 Goal, FWaypointRouteScratch& Scratch) const;
+	/** A* search, fills the scratch's route. Node sized buffers are reused by all searches of the calling thread */
+	void FindPath(int32 From, int32 Goal, FWaypointRouteScratch& Scratch) const;
+	/** Straight line distance, never overestimates since edge costs are distances scaled by at least 1 */
+	float GetHeuristic(int32 Node, int32 Goal) const { return float(FVector3f::Dist(Positions[Node], Positions[Goal])); }
+
+	/** Per node offsets into edge arrays, NumNodes() + 1 entries, same as in the compiled graph */
+	TArray<int32> Offsets;
+	/** Per edge destination node index */
+	TArray<int32> Destinations;
+	/** Per edge cost, distance between its nodes times destination's cost scale */
+	TArray<float> EdgeLengths;
+	/** Per node offsets into InEdges, NumNodes() + 1 entries */
+	TArray<int32> InOffsets;
+	/** Incoming edges grouped by destination node */
+	TArray<FIncomingEdge> InEdges;
+	/** Per node location */
+	TArray<FVector3f> Positions;
+	/** Per node enabled state, disabled nodes can't be entered */
+	TBitArray<> EnabledNodes;
+	/** [Goal * NumNodes() + From] first node of the route, INDEX_NONE if unreachable. Empty for large graphs */
+	TArray<int16> NextHops;
+	/** [Goal * NumNodes() + From] route length, parallel to NextHops */
+	TArray<float> Distances;
+	/** @see GetVersion() */
+	uint32 Version = 0;
+
+	/** Repair buffers, kept to avoid allocations on every update */
+	TArray<FOpenNode> RowOpen;
+	TArray<int32> RowAffected;
+	TBitArray<> RowAffectedMask;
+	TArray<int32, TInlineAllocator<8>> RowRoots;
+};
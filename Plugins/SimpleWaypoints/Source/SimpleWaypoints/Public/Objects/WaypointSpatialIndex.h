@@ -0,0 +1,61 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+*	Static k-d tree over waypoint locations.
+*
+*	The tree is stored implicitly in a single array: every [Begin, End) range
+*	keeps its splitting node at the middle element, so queries don't need
+*	child pointers and never allocate. Returned values are indices of the
+*	locations passed to Build().
+*
+*	@see AWaypointGraph
+*/
+struct SIMPLEWAYPOINTS_API FWaypointSpatialIndex
+{
+public:
+	/** Rebuilds the tree from scratch */
+	void Build(TConstArrayView<FVector> InLocations);
+	/** Drops all the data */
+	void Reset();
+
+	/** Number of indexed locations */
+	int32 Num() const { return Locations.Num(); }
+	bool IsEmpty() const { return Locations.IsEmpty(); }
+
+	/** Returns index of the closest location or INDEX_NONE if empty */
+	int32 FindNearest(const FVector& ToLocation) const;
+	/** Returns index of the most distant location or INDEX_NONE if empty */
+	int32 FindFarthest(const FVector& ToLocation) const;
+	/**
+	*	Fills OutIndices with up to OutIndices.Num() closest locations, sorted by distance.
+	*	Returns the number of written entries.
+	*/
+	int32 FindKNearest(const FVector& ToLocation, TArrayView<int32> OutIndices) const;
+
+private:
+	struct FNode
+	{
+		/** Bounds of the whole subtree this node splits */
+		FBox Bounds;
+		/** Index into Locations */
+		int32 PointIndex = INDEX_NONE;
+		/** Splitting axis (0 - X, 1 - Y, 2 - Z) */
+		uint8 Axis = 0;
+	};
+
+	void BuildRecursive(int32 Begin, int32 End);
+	void FindNearestRecursive(int32 Begin, int32 End, const FVector& ToLocation, int32& BestIndex, double& BestDistSq) const;
+	void FindFarthestRecursive(int32 Begin, int32 End, const FVector& ToLocation, int32& BestIndex, double& BestDistSq) const;
+	void FindKNearestRecursive(int32 Begin, int32 End, const FVector& ToLocation, TArrayView<int32> OutIndices, int32& OutCount) const;
+
+	static double GetMaxDistSquared(const FBox& Box, const FVector& ToLocation);
+
+	/** Source locations, indexed the same way as passed to Build() */
+	TArray<FVector> Locations;
+	/** Implicit tree, see class description */
+	TArray<FNode> Nodes;
+};
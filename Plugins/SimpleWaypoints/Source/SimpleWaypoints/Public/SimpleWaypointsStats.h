@@ -0,0 +1,45 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+*	Profiling of the waypoint pipeline.
+*
+*	Cycle stats and counters are visible with "stat SimpleWaypoints".
+*	Insights scopes are emitted on the SimpleWaypoints trace channel,
+*	enable it with -trace=cpu,SimpleWaypoints (or Trace.Enable SimpleWaypoints).
+*/
+
+DECLARE_STATS_GROUP(TEXT("SimpleWaypoints"), STATGROUP_SimpleWaypoints, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Select Waypoint"), STAT_SelectWaypoint, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Filter Destinations"), STAT_FilterDestinations, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Check Conditions"), STAT_CheckConditions, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Get Nearest Point"), STAT_GetNearestPoint, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Set Behavior Parameters"), STAT_SetWaypointBehaviorParameters, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Route Table"), STAT_BuildRouteTable, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find Waypoint Route"), STAT_FindWaypointRoute, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Repair Route Table"), STAT_RepairRouteTable, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find Waypoint Path"), STAT_FindWaypointPath, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Selections"), STAT_WaypointSelections, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rejected: Cooldown"), STAT_WaypointRejectedCooldown, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rejected: Occupied"), STAT_WaypointRejectedOccupied, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rejected: Conditions"), STAT_WaypointRejectedConditions, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rejected: Pending Conditions"), STAT_WaypointRejectedPending, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rejected: Visited"), STAT_WaypointRejectedVisited, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Cooldown Entries"), STAT_WaypointCooldownEntries, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Condition Cache Hits"), STAT_WaypointConditionCacheHits, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Path Cache Hits"), STAT_WaypointPathCacheHits, STATGROUP_SimpleWaypoints, SIMPLEWAYPOINTS_API);
+
+UE_TRACE_CHANNEL_EXTERN(SimpleWaypointsChannel, SIMPLEWAYPOINTS_API);
+
+/** Cycle stat and Insights scope in one, Name is the STAT_ suffix */
+#define SIMPLEWAYPOINTS_SCOPE(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, SimpleWaypointsChannel)
@@ -0,0 +1,77 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "WaypointPathCacheSubsystem.generated.h"
+
+/**
+*	Navigation paths between waypoints, shared by all agents moving along the same edge.
+*
+*	Paths are found once per (source, destination, navigation data, filter class), agents
+*	follow copies of them. Navigation data observes cached paths like any other path: when
+*	navmesh tiles they cross get rebuilt, they are invalidated and recalculated in place.
+*	Paths that failed to recalculate are dropped on the next lookup.
+*
+*	Waypoints are assumed to stay in place during play.
+*	Cache size is limited by SimpleWaypoints.PathCacheMaxEntries, least recently used
+*	paths are evicted when it's full.
+*
+*	@see UMoveToWaypoint
+*/
+
+class AAIController;
+class ANavigationData;
+class AWaypoint;
+class UNavigationQueryFilter;
+
+UCLASS()
+class SIMPLEWAYPOINTS_API UWaypointPathCacheSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	*	Returns path from Source to Destination for the controller's agent, finds it first if it isn't cached. Null if there's no full path.
+	*	Returned path is shared, copy it before following.
+	*/
+	FNavPathSharedPtr FindPath(const AAIController& Controller, const AWaypoint& Source, const AWaypoint& Destination, TSubclassOf<UNavigationQueryFilter> FilterClass);
+	/** Drops all cached paths */
+	void Reset() { Paths.Reset(); }
+	/** Number of cached paths */
+	int32 Num() const { return Paths.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FPathKey
+	{
+		TObjectKey<AWaypoint> Source;
+		TObjectKey<AWaypoint> Destination;
+		TObjectKey<ANavigationData> NavData;
+		TObjectKey<UClass> FilterClass;
+
+		bool operator==(const FPathKey& Other) const = default;
+		friend uint32 GetTypeHash(const FPathKey& Key)
+		{
+			return HashCombineFast(HashCombineFast(GetTypeHash(Key.Source), GetTypeHash(Key.Destination)), HashCombineFast(GetTypeHash(Key.NavData), GetTypeHash(Key.FilterClass)));
+		}
+	};
+
+	struct FCachedPath
+	{
+		FNavPathSharedPtr Path;
+		/** GFrameCounter of the last lookup */
+		uint64 LastUsedFrame = 0;
+	};
+
+	/** Removes paths that can't be used anymore and ones of destroyed waypoints */
+	void PrunePaths();
+	/** Removes least recently used paths until there's room for NumToAdd more */
+	void EvictPaths(int32 NumToAdd);
+
+	TMap<FPathKey, FCachedPath> Paths;
+};
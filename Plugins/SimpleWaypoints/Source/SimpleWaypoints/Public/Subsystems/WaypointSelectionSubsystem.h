@@ -0,0 +1,84 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Objects/WaypointFollower.h"
+#include "WaypointSelectionSubsystem.generated.h"
+
+/**
+*	Queues waypoint selection requests and resolves them once per frame
+*	within a time budget (SimpleWaypoints.SelectionBudgetMs), so the cost
+*	of many followers re-planning at once is spread over multiple frames.
+*
+*	Every follower can have at most one pending request, requesting again
+*	replaces the callback of the previous one.
+*
+*	With SimpleWaypoints.ParallelSelection requests are resolved in batches.
+*	Data only filtering runs in ParallelFor, while conditions (which may touch
+*	UObjects) and occupancy claims are applied on game thread in request order.
+*
+*	If no destination is available yet because of pending async conditions, the request
+*	is moved to the back of the queue and retried next frame, up to
+*	SimpleWaypoints.MaxConditionWaitFrames times.
+*
+*	@see UWaypointFollower
+*	@see USelectWaypoint
+*/
+
+class AWaypoint;
+
+DECLARE_DELEGATE_OneParam(FOnWaypointSelected, AWaypoint* /*SelectedWaypoint*/);
+
+UCLASS()
+class SIMPLEWAYPOINTS_API UWaypointSelectionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Queues selection for the follower. Callback is executed on game thread once it's resolved */
+	void RequestSelection(UWaypointFollower* Follower, FOnWaypointSelected Callback);
+	/** Drops pending request of the follower, if there's any. Safe to call from selection callbacks */
+	void CancelSelection(UWaypointFollower* Follower);
+	/** */
+	bool HasPendingSelection(const UWaypointFollower* Follower) const { return PendingFollowers.Contains(Follower); }
+	/** */
+	int32 GetNumPendingSelections() const { return PendingRequests.Num(); }
+
+	// UTickableWorldSubsystem
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FSelectionRequest
+	{
+		/** Reset once the request is processed or cancelled */
+		TWeakObjectPtr<UWaypointFollower> Follower;
+		FOnWaypointSelected Callback;
+		/** Number of frames the request already waited for async conditions */
+		int32 NumWaits = 0;
+	};
+
+	/** Puts the request back at the end of the queue */
+	void RequeueRequest(UWaypointFollower* Follower, FOnWaypointSelected&& Callback, int32 NumWaits);
+
+	/** Resolves requests in FIFO order until the budget runs out */
+	void ProcessRequests();
+	/** Resolves requests in parallel batches until the budget runs out */
+	void ProcessRequestsParallel();
+
+	/** FIFO of requests */
+	TArray<FSelectionRequest> PendingRequests;
+	/** Followers with a request in PendingRequests, keeps RequestSelection() O(1) */
+	TSet<TObjectKey<UWaypointFollower>> PendingFollowers;
+
+	/** Scratch data of the current parallel batch, kept to reuse allocations */
+	TArray<FWaypointPendingSelection> BatchSelections;
+	TArray<UWaypointFollower*> BatchFollowers;
+	TArray<FOnWaypointSelected> BatchCallbacks;
+	TArray<int32> BatchWaits;
+};
@@ -39,6 +39,7 @@ public class SimpleWaypoints : ModuleRules
 				"Slate",
 				"SlateCore",
                 "AIModule",
+				"NavigationSystem",
 				"GameplayTags",
                 "UnrealEd",
 				"ExtraLogic",
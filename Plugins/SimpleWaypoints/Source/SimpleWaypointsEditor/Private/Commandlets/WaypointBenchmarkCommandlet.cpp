@@ -0,0 +1,268 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+
+#include "Commandlets/WaypointBenchmarkCommandlet.h"
+#include "Objects/WaypointGraph.h"
+#include "Objects/Waypoint.h"
+#include "Objects/WaypointFollower.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWaypointBenchmark, Log, All);
+
+namespace WaypointBenchmark
+{
+	/** Allocator calls counted by the engine, on all threads. Zero without stats */
+	static uint64 GetNumAllocations()
+	{
+#if UE_STATS
+		return uint64(FMalloc::TotalMallocCalls) + uint64(FMalloc::TotalReallocCalls);
+#else
+		return 0;
+#endif
+	}
+
+	struct FSettings
+	{
+		TArray<int32> NodeCounts = { 100, 1000, 10000, 100000 };
+		int32 Degree = 4;
+		int32 Followers = 2000;
+		int32 Cycles = 20;
+		float ConditionRatio = 0.1f;
+		int32 MaxUsers = 4;
+		float FailRatio = 0.1f;
+		int32 Seed = 0;
+		/** Pass/fail thresholds, 0 disables the check */
+		float MinSelectionsPerSecond = 0.f;
+		float MaxP99Microseconds = 0.f;
+		float MaxAllocationsPerSelection = 0.f;
+	};
+
+	struct FResult
+	{
+		int32 NumSelections = 0;
+		/** Selections that returned right away, e.g. because the current waypoint wasn't reached */
+		int32 NumSkipped = 0;
+		double TotalSeconds = 0.0;
+		double P50Microseconds = 0.0;
+		double P99Microseconds = 0.0;
+		double AllocationsPerSelection = 0.0;
+	};
+
+	static FSettings ParseSettings(const FString& Params)
+	{
+		FSettings Settings;
+
+		FString NodesParam;
+		if (FParse::Value(*Params, TEXT("Nodes="), NodesParam))
+		{
+			TArray<FString> NodeStrings;
+			NodesParam.ParseIntoArray(NodeStrings, TEXT(","));
+			Settings.NodeCounts.Reset();
+			for (const FString& NodeString : NodeStrings)
+			{
+				Settings.NodeCounts.Add(FMath::Max(2, FCString::Atoi(*NodeString)));
+			}
+		}
+		FParse::Value(*Params, TEXT("Degree="), Settings.Degree);
+		FParse::Value(*Params, TEXT("Followers="), Settings.Followers);
+		FParse::Value(*Params, TEXT("Cycles="), Settings.Cycles);
+		FParse::Value(*Params, TEXT("ConditionRatio="), Settings.ConditionRatio);
+		FParse::Value(*Params, TEXT("MaxUsers="), Settings.MaxUsers);
+		FParse::Value(*Params, TEXT("FailRatio="), Settings.FailRatio);
+		FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+		FParse::Value(*Params, TEXT("MinSelectionsPerSec="), Settings.MinSelectionsPerSecond);
+		FParse::Value(*Params, TEXT("MaxP99Us="), Settings.MaxP99Microseconds);
+		FParse::Value(*Params, TEXT("MaxAllocsPerSelection="), Settings.MaxAllocationsPerSelection);
+
+		Settings.Degree = FMath::Max(1, Settings.Degree);
+		Settings.MaxUsers = FMath::Clamp(Settings.MaxUsers, 1, 255);
+		return Settings;
+	}
+
+	static AWaypointGraph* BuildGraph(UWorld* World, int32 NumNodes, const FSettings& Settings, FRandomStream& Random)
+	{
+		const double Extent = 100.0 * FMath::Sqrt(double(NumNodes));
+
+		TArray<AWaypoint*> Waypoints;
+		Waypoints.Reserve(NumNodes);
+		for (int32 i = 0; i < NumNodes; ++i)
+		{
+			const FVector Location(Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent), 0.0);
+			AWaypoint* Waypoint = World->SpawnActor<AWaypoint>(AWaypoint::StaticClass(), Location, FRotator::ZeroRotator);
+			Waypoint->SetMaxUsers(uint8(Random.RandRange(1, Settings.MaxUsers)));
+			Waypoint->SetCooldown(5.f);
+			if (Random.FRand() < Settings.ConditionRatio)
+			{
+				Waypoint->AddCondition(NewObject<UWaypointBenchmarkCondition>(Waypoint));
+			}
+			Waypoints.Add(Waypoint);
+		}
+
+		// Out-degree varies between 1 and 2 * Degree - 1, so the average stays at Degree
+		for (AWaypoint* Waypoint : Waypoints)
+		{
+			const int32 OutDegree = Random.RandRange(1, 2 * Settings.Degree - 1);
+			for (int32 Edge = 0; Edge < OutDegree; ++Edge)
+			{
+				AWaypoint* Destination = Waypoints[Random.RandRange(0, NumNodes - 1)];
+				if (Destination != Waypoint)
+				{
+					Waypoint->SetDestination(Destination, uint8(Random.RandRange(0, 255)));
+				}
+			}
+		}
+
+		// Deferred, so the spatial index and adjacency are built only once in BeginPlay
+		AWaypointGraph* Graph = World->SpawnActorDeferred<AWaypointGraph>(AWaypointGraph::StaticClass(), FTransform::Identity);
+		Graph->Waypoints = MoveTemp(Waypoints);
+		Graph->FinishSpawning(FTransform::Identity);
+		return Graph;
+	}
+
+	static FResult RunCycles(UWorld* World, AWaypointGraph* Graph, const FSettings& Settings, FRandomStream& Random)
+	{
+		const double Extent = 100.0 * FMath::Sqrt(double(Graph->GetWaypointCount()));
+
+		TArray<UWaypointFollower*> Followers;
+		Followers.Reserve(Settings.Followers);
+		for (int32 i = 0; i < Settings.Followers; ++i)
+		{
+			const FVector Location(Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent), 0.0);
+			AActor* Owner = World->SpawnActor<AActor>(AActor::StaticClass(), Location, FRotator::ZeroRotator);
+			UWaypointFollower* Follower = NewObject<UWaypointFollower>(Owner);
+			Follower->RegisterComponent();
+			Follower->SetWaypointGraph(Graph);
+			Followers.Add(Follower);
+		}
+
+		// Initial nearest point selection isn't part of the measurement
+		for (UWaypointFollower* Follower : Followers)
+		{
+			Follower->SelectWaypoint();
+			Follower->ReachWaypoint();
+		}
+
+		FResult Result;
+		TArray<double> Latencies;
+		Latencies.Reserve(Settings.Followers * Settings.Cycles);
+
+		uint64 SelectionAllocations = 0;
+		for (int32 Cycle = 0; Cycle < Settings.Cycles; ++Cycle)
+		{
+			for (UWaypointFollower* Follower : Followers)
+			{
+				// Selection returns the current waypoint until it's reached, that isn't worth measuring
+				if (!Follower->GetCurrentWaypoint() || Follower->GetLastReachedWaypoint() != Follower->GetCurrentWaypoint())
+				{
+					++Result.NumSkipped;
+					continue;
+				}
+
+				const uint64 AllocationsBefore = GetNumAllocations();
+				const uint64 StartCycles = FPlatformTime::Cycles64();
+
+				Follower->SelectWaypoint();
+
+				const uint64 EndCycles = FPlatformTime::Cycles64();
+				SelectionAllocations += GetNumAllocations() - AllocationsBefore;
+				Latencies.Add(FPlatformTime::ToSeconds64(EndCycles - StartCycles));
+
+				// Simulate failed movement for some of the agents. They put the waypoint on cooldown
+				// and go on from it, as if they found their own way there
+				if (Random.FRand() < Settings.FailRatio)
+				{
+					Follower->IgnoreWaypoint(const_cast<AWaypoint*>(Follower->GetCurrentWaypoint()));
+				}
+				Follower->ReachWaypoint();
+			}
+
+			// Let cooldowns expire
+			World->Tick(LEVELTICK_All, 1.f / 30.f);
+		}
+
+		Latencies.Sort();
+		Result.NumSelections = Latencies.Num();
+		for (const double Latency : Latencies)
+		{
+			Result.TotalSeconds += Latency;
+		}
+		if (!Latencies.IsEmpty())
+		{
+			Result.P50Microseconds = Latencies[Latencies.Num() / 2] * 1e6;
+			Result.P99Microseconds = Latencies[FMath::Min(Latencies.Num() - 1, Latencies.Num() * 99 / 100)] * 1e6;
+			Result.AllocationsPerSelection = double(SelectionAllocations) / Latencies.Num();
+		}
+		return Result;
+	}
+}
+
+UWaypointBenchmarkCommandlet::UWaypointBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UWaypointBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace WaypointBenchmark;
+
+	const FSettings Settings = ParseSettings(Params);
+	FRandomStream Random(Settings.Seed);
+	// Selection itself uses FMath random functions
+	FMath::RandInit(Settings.Seed);
+
+	UE_LOG(LogWaypointBenchmark, Display, TEXT("Nodes | Selections | Skipped | Selections/s | p50 us | p99 us | Allocs/selection"));
+
+	int32 NumFailures = 0;
+	for (const int32 NumNodes : Settings.NodeCounts)
+	{
+		UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+
+		AWaypointGraph* Graph = BuildGraph(World, NumNodes, Settings, Random);
+		const FResult Result = RunCycles(World, Graph, Settings, Random);
+
+		const double SelectionsPerSecond = Result.TotalSeconds > 0.0 ? Result.NumSelections / Result.TotalSeconds : 0.0;
+		UE_LOG(LogWaypointBenchmark, Display, TEXT("%d | %d | %d | %.0f | %.2f | %.2f | %.2f"),
+			NumNodes,
+			Result.NumSelections,
+			Result.NumSkipped,
+			SelectionsPerSecond,
+			Result.P50Microseconds,
+			Result.P99Microseconds,
+			Result.AllocationsPerSelection);
+
+		if (Settings.MinSelectionsPerSecond > 0.f && SelectionsPerSecond < Settings.MinSelectionsPerSecond)
+		{
+			UE_LOG(LogWaypointBenchmark, Error, TEXT("%d nodes: %.0f selections/s is below %.0f"), NumNodes, SelectionsPerSecond, Settings.MinSelectionsPerSecond);
+			++NumFailures;
+		}
+		if (Settings.MaxP99Microseconds > 0.f && Result.P99Microseconds > Settings.MaxP99Microseconds)
+		{
+			UE_LOG(LogWaypointBenchmark, Error, TEXT("%d nodes: p99 %.2f us is above %.2f us"), NumNodes, Result.P99Microseconds, Settings.MaxP99Microseconds);
+			++NumFailures;
+		}
+		if (Settings.MaxAllocationsPerSelection > 0.f && Result.AllocationsPerSelection > Settings.MaxAllocationsPerSelection)
+		{
+			UE_LOG(LogWaypointBenchmark, Error, TEXT("%d nodes: %.2f allocations per selection is above %.2f"), NumNodes, Result.AllocationsPerSelection, Settings.MaxAllocationsPerSelection);
+			++NumFailures;
+		}
+
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	return NumFailures > 0 ? 1 : 0;
+}
+
+bool UWaypointBenchmarkCondition::Condition(UObject* Context) const
+{
+	return FMath::FRand() < PassChance;
+}
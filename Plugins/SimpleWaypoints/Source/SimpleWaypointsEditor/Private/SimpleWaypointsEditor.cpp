@@ -0,0 +1,5 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SimpleWaypointsEditor.h"
+
+IMPLEMENT_MODULE(FSimpleWaypointsEditorModule, SimpleWaypointsEditor)
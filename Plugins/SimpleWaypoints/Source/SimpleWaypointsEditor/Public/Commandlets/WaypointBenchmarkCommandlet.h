@@ -0,0 +1,53 @@
+// Copyright 2025 Crippling Depression Ind. all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Conditions/BaseCondition.h"
+#include "WaypointBenchmarkCommandlet.generated.h"
+
+/**
+*	Measures waypoint selection throughput on procedurally built graphs.
+*
+*	For every graph size a fresh game world is created with random waypoints,
+*	destinations, MaxUsers and conditions. Followers then run
+*	SelectWaypoint / ReachWaypoint / IgnoreWaypoint cycles and the commandlet
+*	reports selections per second, p50/p99 latency and allocations per selection.
+*	Allocations are the engine's allocator call counters (stats builds only), so
+*	allocations of other threads during a selection are included.
+*
+*	Returns 1 if any graph size misses one of the optional thresholds, so CI can
+*	fail on regressions.
+*
+*	Usage:
+*	UnrealEditor-Cmd <Project> -run=WaypointBenchmark -nullrhi -unattended
+*		[-Nodes=100,1000,10000,100000] [-Degree=4] [-Followers=2000] [-Cycles=20]
+*		[-ConditionRatio=0.1] [-MaxUsers=4] [-FailRatio=0.1] [-Seed=0]
+*		[-MinSelectionsPerSec=0] [-MaxP99Us=0] [-MaxAllocsPerSelection=0]
+*/
+UCLASS()
+class SIMPLEWAYPOINTSEDITOR_API UWaypointBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UWaypointBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
+
+/**
+*	Condition used by UWaypointBenchmarkCommandlet, passes randomly with PassChance.
+*/
+UCLASS(NotBlueprintable, Transient)
+class SIMPLEWAYPOINTSEDITOR_API UWaypointBenchmarkCondition : public UBaseCondition
+{
+	GENERATED_BODY()
+
+public:
+	float PassChance = 0.75f;
+
+protected:
+	virtual bool Condition(UObject* Context) const override;
+};